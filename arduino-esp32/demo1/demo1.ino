@@ -31,6 +31,7 @@
  */
 
 #include "ws2812.h"
+#include "ws2812_effects.h"
 
 #if defined(ARDUINO) && ARDUINO >= 100
   // No extras
@@ -46,11 +47,18 @@ uint8_t MAX_COLOR_VAL = 32; // Limits brightness
 
 int pausetime = 500;
 
-rgbVal *pixels;
+grbVal *pixels; // Points straight into the driver's wire-order buffer
+
+typedef struct {
+  rgbVal color;
+  uint8_t stepVal;
+} rainbowState;
+
+rainbowState rainbows[2]; // Each running copy of an effect needs its own state
 
 void displayOff();
-void rainbow(unsigned long, unsigned long);
-void scanner(unsigned long, unsigned long);
+void rainbow(rgbVal *, uint32_t, uint32_t, void *);
+void scanner(rgbVal *, uint32_t, uint32_t, void *);
 void dumpDebugBuffer(int, char *);
 
 void dumpDebugBuffer(int id, char * debugBuffer) {
@@ -71,11 +79,27 @@ void setup() {
   #if DEBUG_WS2812_DRIVER
     dumpDebugBuffer(-2, ws2812_debugBuffer);
   #endif
-  pixels = (rgbVal*)malloc(sizeof(rgbVal) * NUM_PIXELS);
+  // Size the framebuffer before taking a pointer into it - growing it moves it
+  ws2812_effectsInit(NUM_PIXELS);
+  pixels = ws2812_getPixels(NUM_PIXELS);
   displayOff();
   #if DEBUG_WS2812_DRIVER
     dumpDebugBuffer(-1, ws2812_debugBuffer);
   #endif
+
+  // Two halves of the strip, each with its own playlist and frame rate
+  int left = ws2812_strandAdd(0, NUM_PIXELS / 2, 10);
+  int right = ws2812_strandAdd(NUM_PIXELS / 2, NUM_PIXELS / 2, 20);
+  ws2812_playlistEntry leftShow[] = {
+    {rainbow, &rainbows[0], 5000, 0},
+    {scanner, NULL, 5000, 1000},
+  };
+  ws2812_playlistEntry rightShow[] = {
+    {scanner, NULL, 5000, 0},
+    {rainbow, &rainbows[1], 5000, 1000},
+  };
+  ws2812_strandPlay(left, leftShow, 2, true);
+  ws2812_strandPlay(right, rightShow, 2, true);
   Serial.println("Init complete");
 }
 
@@ -83,20 +107,17 @@ int passes = 0;
 int MAX_PASSES = 10;
 
 void loop() {
-  rainbow(0, 5000);
-  scanner(0, 5000);
-  displayOff();
+  ws2812_effectsPoll(millis());
 }
 
 void loop_FOR_DEBUG_TESTING() {
   for(uint16_t i=0; i<NUM_PIXELS; i++) {
-    pixels[i] = makeRGBVal(1, 1, 1);
+    pixels[i] = makeGRBVal(1, 1, 1);
   }
-  pixels[0] = makeRGBVal(2, 1, 3);
-  pixels[1] = makeRGBVal(5, 4, 6);
-  pixels[2] = makeRGBVal(8, 7, 9);
-  ws2812_setColors(2, pixels);
-  //ws2812_setColors(NUM_PIXELS, pixels);
+  pixels[0] = makeGRBVal(2, 1, 3);
+  pixels[1] = makeGRBVal(5, 4, 6);
+  pixels[2] = makeGRBVal(8, 7, 9);
+  ws2812_show();
   #if DEBUG_WS2812_DRIVER
     dumpDebugBuffer(passes, ws2812_debugBuffer);
   #endif
@@ -108,90 +129,70 @@ void loop_FOR_DEBUG_TESTING() {
 
 void displayOff() {
   for (int i = 0; i < NUM_PIXELS; i++) {
-    pixels[i] = makeRGBVal(0, 0, 0);
+    pixels[i] = makeGRBVal(0, 0, 0);
   }
-  ws2812_setColors(2, pixels);
-  //ws2812_setColors(NUM_PIXELS, pixels);
+  ws2812_show();
 }
 
-void scanner(unsigned long delay_ms, unsigned long timeout_ms) {
-  int currIdx = 0;
-  int prevIxd = 0;
-  bool RUN_FOREVER = (timeout_ms == 0 ? true : false);
-  unsigned long start_ms = millis();
-  while (RUN_FOREVER || (millis() - start_ms < timeout_ms)) {
-    pixels[prevIxd] = makeRGBVal(0, 0, 0);
-    pixels[currIdx] = makeRGBVal(MAX_COLOR_VAL, MAX_COLOR_VAL, MAX_COLOR_VAL);;
-    ws2812_setColors(NUM_PIXELS, pixels);
-    prevIxd = currIdx;
-    currIdx++;
-    if (currIdx >= NUM_PIXELS) {
-      currIdx = 0;
-    }
-    delay(delay_ms);
-  }
+void scanner(rgbVal *strand, uint32_t count, uint32_t frame, void *state) {
+  uint32_t currIdx = frame % count;
+  strand[(currIdx + count - 1) % count] = makeRGBVal(0, 0, 0);
+  strand[currIdx] = makeRGBVal(MAX_COLOR_VAL, MAX_COLOR_VAL, MAX_COLOR_VAL);
 }
 
-void rainbow(unsigned long delay_ms, unsigned long timeout_ms)
+void rainbow(rgbVal *strand, uint32_t count, uint32_t frame, void *state)
 {
   const uint8_t color_div = 4;
   const uint8_t anim_step = 1;
   const uint8_t anim_max = MAX_COLOR_VAL - anim_step;
-  rgbVal color = makeRGBVal(anim_max, 0, 0);
-  rgbVal color2 = makeRGBVal(anim_max, 0, 0);
-  uint8_t stepVal = 0;
-  uint8_t stepVal2 = 0;
-
-  bool RUN_FOREVER = (timeout_ms == 0 ? true : false);
-  unsigned long start_ms = millis();
-  while (RUN_FOREVER || (millis() - start_ms < timeout_ms)) {
-    color = color2;
-    stepVal = stepVal2;
-  
-    for (uint16_t i = 0; i < NUM_PIXELS; i++) {
-      pixels[i] = makeRGBVal(color.r/color_div, color.g/color_div, color.b/color_div);
-  
-      if (i == 1) {
-        color2 = color;
-        stepVal2 = stepVal;
-      }
-  
-      switch (stepVal) {
-        case 0:
-        color.g += anim_step;
-        if (color.g >= anim_max)
-          stepVal++;
-        break;
-        case 1:
-        color.r -= anim_step;
-        if (color.r == 0)
-          stepVal++;
-        break;
-        case 2:
-        color.b += anim_step;
-        if (color.b >= anim_max)
-          stepVal++;
-        break;
-        case 3:
-        color.g -= anim_step;
-        if (color.g == 0)
-          stepVal++;
-        break;
-        case 4:
-        color.r += anim_step;
-        if (color.r >= anim_max)
-          stepVal++;
-        break;
-        case 5:
-        color.b -= anim_step;
-        if (color.b == 0)
-          stepVal = 0;
-        break;
-      }
+  rainbowState *rs = (rainbowState *) state;
+
+  if (frame == 0) {
+    rs->color = makeRGBVal(anim_max, 0, 0);
+    rs->stepVal = 0;
+  }
+  rgbVal color = rs->color;
+  uint8_t stepVal = rs->stepVal;
+
+  for (uint32_t i = 0; i < count; i++) {
+    strand[i] = makeRGBVal(color.r/color_div, color.g/color_div, color.b/color_div);
+
+    if (i == 1) {
+      rs->color = color;
+      rs->stepVal = stepVal;
+    }
+
+    switch (stepVal) {
+      case 0:
+      color.g += anim_step;
+      if (color.g >= anim_max)
+        stepVal++;
+      break;
+      case 1:
+      color.r -= anim_step;
+      if (color.r == 0)
+        stepVal++;
+      break;
+      case 2:
+      color.b += anim_step;
+      if (color.b >= anim_max)
+        stepVal++;
+      break;
+      case 3:
+      color.g -= anim_step;
+      if (color.g == 0)
+        stepVal++;
+      break;
+      case 4:
+      color.r += anim_step;
+      if (color.r >= anim_max)
+        stepVal++;
+      break;
+      case 5:
+      color.b -= anim_step;
+      if (color.b == 0)
+        stepVal = 0;
+      break;
     }
-  
-    ws2812_setColors(NUM_PIXELS, pixels);
-  
-    delay(delay_ms);
   }
 }
@@ -0,0 +1,7 @@
+#
+# Component Makefile for the digital RGB LED driver. The same directory is
+# also an Arduino library (see library.properties), so the sources live in src/.
+#
+
+COMPONENT_ADD_INCLUDEDIRS := src
+COMPONENT_SRCDIRS := src
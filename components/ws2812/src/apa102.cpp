@@ -0,0 +1,93 @@
+/* 
+ * Frame builder for APA102/SK9822 clocked RGB LEDs.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "apa102.h"
+
+#define APA102_HEADER     0xE0 /* Top three bits of every pixel frame are set */
+#define APA102_MAX_GLOBAL   31 /* 5-bit global brightness */
+
+uint32_t apa102_frameSize(uint32_t numPixels)
+{
+  // Start frame, pixels, SK9822 reset frame, then one bit per two pixels of extra clocking
+  return 4 + numPixels * 4 + 4 + (numPixels + 15) / 16;
+}
+
+uint8_t *apa102_startFrame(uint8_t *dst)
+{
+  dst[0] = dst[1] = dst[2] = dst[3] = 0;
+
+  return dst + 4;
+}
+
+uint8_t *apa102_addPixel(uint8_t *dst, uint8_t r, uint8_t g, uint8_t b, uint8_t brightness)
+{
+  // The wanted intensity of a channel c is (c / 255) * (brightness / 255). Pick the smallest
+  // global value that can still reach it on the brightest channel, then stretch the colour
+  // values to fill their 8 bits at that global level.
+  uint32_t maxc = r > g ? (r > b ? r : b) : (g > b ? g : b);
+  uint32_t scaled = maxc * brightness;
+  uint32_t global = (scaled * APA102_MAX_GLOBAL + (255 * 255 - 1)) / (255 * 255);
+
+  if (!global) {
+    dst[0] = APA102_HEADER;
+    dst[1] = dst[2] = dst[3] = 0;
+    return dst + 4;
+  }
+
+  uint32_t num = brightness * APA102_MAX_GLOBAL;
+  uint32_t den = global * 255;
+  dst[0] = APA102_HEADER | global;
+  dst[1] = (b * num + den / 2) / den;
+  dst[2] = (g * num + den / 2) / den;
+  dst[3] = (r * num + den / 2) / den;
+
+  return dst + 4;
+}
+
+uint8_t *apa102_endFrame(uint8_t *dst, uint32_t numPixels)
+{
+  // Zeros rather than ones, so an extra pixel on the end of the strip is never lit
+  uint32_t i, len = 4 + (numPixels + 15) / 16;
+
+  for (i = 0; i < len; i++) {
+    dst[i] = 0;
+  }
+
+  return dst + len;
+}
+
+uint32_t apa102_buildFrame(uint8_t *dst, const grbVal *pixels, uint32_t numPixels, uint8_t brightness)
+{
+  uint8_t *p = apa102_startFrame(dst);
+  uint32_t i;
+
+  for (i = 0; i < numPixels; i++) {
+    p = apa102_addPixel(p, pixels[i].r, pixels[i].g, pixels[i].b, brightness);
+  }
+  p = apa102_endFrame(p, numPixels);
+
+  return p - dst;
+}
@@ -0,0 +1,53 @@
+/*
+ * Frame builder for APA102/SK9822 clocked RGB LEDs.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ * A frame is a 32-bit start frame of zeros, one 32-bit frame per pixel
+ * (0b111 + 5-bit global brightness, then blue, green, red) and an end frame
+ * that supplies the extra clock edges needed to push data to the last pixel.
+ * Nothing here touches hardware, so it builds and runs on a host.
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef APA102_FRAME_H
+#define APA102_FRAME_H
+
+#include <stdint.h>
+#include "ws2812.h"
+
+/* Bytes needed for a frame of numPixels, including start and end frames */
+extern uint32_t apa102_frameSize(uint32_t numPixels);
+
+/*
+ * Incremental builders: each writes at dst and returns the next write
+ * position. brightness (0-255) is folded into the 5-bit global brightness
+ * field first, so dim pixels keep the full 8 bits of colour resolution.
+ */
+extern uint8_t *apa102_startFrame(uint8_t *dst);
+extern uint8_t *apa102_addPixel(uint8_t *dst, uint8_t r, uint8_t g, uint8_t b, uint8_t brightness);
+extern uint8_t *apa102_endFrame(uint8_t *dst, uint32_t numPixels);
+
+/* Builds a whole frame from a pixel buffer, returning the number of bytes written */
+extern uint32_t apa102_buildFrame(uint8_t *dst, const grbVal *pixels, uint32_t numPixels, uint8_t brightness);
+
+#endif /* APA102_FRAME_H */
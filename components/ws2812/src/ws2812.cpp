@@ -0,0 +1,668 @@
+/* 
+ * Core of the digital RGB LED driver: pixel storage, segment mapping and
+ * encoding to wire-order bytes. Output is left to a backend (see
+ * ws2812_backend.h), so this file builds on a host as well as the ESP32.
+ *
+ * Modifications Copyright (c) 2017 Martin F. Falatic
+ *
+ * Based on public domain code created 19 Nov 2016 by Chris Osborn <fozztexx@fozztexx.com>
+ * http://insentricity.com
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "ws2812.h"
+#include "ws2812_backend.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  uint32_t start, count;       // Run of logical pixels owned by this segment
+  int      reversed;
+  uint32_t pos, len;           // Byte position within this segment's stream for the current frame
+  int32_t  pixel, step;        // Logical pixel being sent, and +1/-1 towards the next one
+  uint8_t  byteInPixel;
+  uint8_t  pixBytes[3];        // Current pixel expanded to wire order
+  uint32_t chunkStart, chunkLen;           // Logical pixels currently held in chunk (source mode)
+  rgbVal   chunk[WS2812_SOURCE_CHUNK];
+} segmentState;
+
+#if DEBUG_WS2812_DRIVER
+char * ws2812_debugBuffer = NULL;
+#endif
+
+static const ws2812_backend *ws2812_backendImpl = NULL;
+static segmentState ws2812_segs[WS2812_MAX_SEGMENTS];
+static int ws2812_numSegs = 0;
+static uint8_t *ws2812_buffer = NULL;        // Framebuffer in ws2812_format, kept between frames
+static uint32_t ws2812_bufferCapacity = 0;   // Pixels allocated
+static int ws2812_format = FORMAT_GRB888;
+static rgbVal ws2812_palette[WS2812_PALETTE_SIZE];
+static uint32_t ws2812_numPixels = 0;        // Pixels in the current frame
+static ws2812_pixelSource ws2812_source = NULL;
+static void *ws2812_sourceArg = NULL;
+static uint8_t ws2812_brightness = 255;      // As requested
+static uint8_t ws2812_level = 255;           // After power limiting; what the LUT is built for
+static uint8_t ws2812_brightnessLUT[256];
+
+typedef struct {
+  uint32_t red, green, blue;   // uA drawn by one channel at full scale
+  uint32_t idle;               // uA drawn by one LED when dark
+} powerModel;
+
+static powerModel ws2812_power = {16000, 11000, 15000, 1000};  // WS2812B until told otherwise
+static uint32_t ws2812_powerBudget = 0;                     // mA, 0 for no limit
+static uint64_t ws2812_sums[3] = {0, 0, 0};                 // Framebuffer channel totals, R, G, B
+static uint32_t ws2812_indexCounts[WS2812_PALETTE_SIZE];    // Pixels using each palette entry
+static int ws2812_sumsStale = 0;                            // Set once raw pointers are handed out, until the format changes
+static int ws2812_inFlight = 0;                             // Started with ws2812_start() and not yet waited for
+
+static void beginTransmit(uint32_t length);
+static void transmit(uint32_t length);
+
+int ws2812_useBackend(const ws2812_backend *backend, const ws2812_segment *segments, int numSegments)
+{
+  uint32_t start = 0;
+  int i;
+
+  #if DEBUG_WS2812_DRIVER
+    if (!ws2812_debugBuffer) {
+      ws2812_debugBuffer = (char*)calloc(ws2812_debugBufferSz, sizeof(char));
+    }
+  #endif
+
+  if (!backend || numSegments < 1 || numSegments > WS2812_MAX_SEGMENTS) {
+    return -1;
+  }
+  ws2812_waitComplete();
+
+  for (i = 0; i < numSegments; i++) {
+    segmentState *seg = &ws2812_segs[i];
+    seg->start = start;
+    seg->count = segments[i].length;
+    seg->reversed = segments[i].reversed;
+    seg->pos = seg->len = 0;
+    start += segments[i].length;
+  }
+  ws2812_numSegs = numSegments;
+  ws2812_backendImpl = backend;
+
+  ws2812_setBrightness(ws2812_brightness);
+
+  return 0;
+}
+
+void ws2812_setLedType(int ledType)
+{
+  // Typical draw at 5V; clocked parts run all three channels harder
+  switch (ledType) {
+    case LED_APA102:
+    case LED_SK9822:
+      ws2812_power.red = ws2812_power.green = ws2812_power.blue = 20000;
+      ws2812_power.idle = 1000;
+      break;
+    case LED_WS2812:
+    case LED_WS2812B:
+    case LED_SK6812:
+    case LED_WS2813:
+    default:
+      ws2812_power.red = 16000;
+      ws2812_power.green = 11000;
+      ws2812_power.blue = 15000;
+      ws2812_power.idle = 1000;
+      break;
+  }
+
+  return;
+}
+
+static void buildBrightnessLUT(uint8_t level)
+{
+  // Backends that carry brightness in the frame (e.g. APA102) get the colour bytes unscaled
+  uint8_t scale = (ws2812_backendImpl && ws2812_backendImpl->handlesBrightness) ? 255 : level;
+  int i;
+
+  ws2812_level = level;
+  for (i = 0; i < 256; i++) {
+    ws2812_brightnessLUT[i] = (i * scale + 127) / 255;
+  }
+
+  return;
+}
+
+void ws2812_setBrightness(uint8_t brightness)
+{
+  ws2812_brightness = brightness;
+  buildBrightnessLUT(brightness);
+
+  return;
+}
+
+uint8_t ws2812_getBrightness()
+{
+  return ws2812_level;
+}
+
+static void expandPixel(uint32_t p, uint8_t *grb)
+{
+  // Expands one framebuffer pixel to wire order
+  switch (ws2812_format) {
+    case FORMAT_GRB888:
+      grb[0] = ws2812_buffer[p * 3 + 0];
+      grb[1] = ws2812_buffer[p * 3 + 1];
+      grb[2] = ws2812_buffer[p * 3 + 2];
+      break;
+    case FORMAT_RGB565: {
+      // Replicate the top bits into the bottom ones so full scale stays full scale
+      uint16_t v = ((uint16_t *) ws2812_buffer)[p];
+      uint8_t r = v >> 11, g = (v >> 5) & 0x3F, b = v & 0x1F;
+      grb[0] = (g << 2) | (g >> 4);
+      grb[1] = (r << 3) | (r >> 2);
+      grb[2] = (b << 3) | (b >> 2);
+      break;
+    }
+    case FORMAT_PLANAR:
+      grb[0] = ws2812_buffer[PLANE_G * ws2812_bufferCapacity + p];
+      grb[1] = ws2812_buffer[PLANE_R * ws2812_bufferCapacity + p];
+      grb[2] = ws2812_buffer[PLANE_B * ws2812_bufferCapacity + p];
+      break;
+    case FORMAT_INDEXED8: {
+      const rgbVal *c = &ws2812_palette[ws2812_buffer[p]];
+      grb[0] = c->g;
+      grb[1] = c->r;
+      grb[2] = c->b;
+      break;
+    }
+  }
+
+  return;
+}
+
+static void fetchPixel(segmentState *seg, uint8_t *grb)
+{
+  // Expands this segment's current pixel, from the pixel source or the framebuffer, to wire order
+  uint32_t p = seg->pixel;
+
+  if (ws2812_source) {
+    uint32_t idx = p - seg->chunkStart;
+    if (idx >= seg->chunkLen) {
+      // Pull the next chunk, covering the pixels this segment will send after this one
+      uint32_t first = seg->start;
+      uint32_t last = seg->start + seg->len / 3 - 1;
+      if (seg->reversed) {
+        seg->chunkStart = (p - first >= WS2812_SOURCE_CHUNK) ? p - (WS2812_SOURCE_CHUNK - 1) : first;
+        seg->chunkLen = p - seg->chunkStart + 1;
+      }
+      else {
+        seg->chunkStart = p;
+        seg->chunkLen = (last - p >= WS2812_SOURCE_CHUNK) ? WS2812_SOURCE_CHUNK : last - p + 1;
+      }
+      ws2812_source(seg->chunkStart, seg->chunkLen, seg->chunk, ws2812_sourceArg);
+      idx = p - seg->chunkStart;
+    }
+    grb[0] = seg->chunk[idx].g;
+    grb[1] = seg->chunk[idx].r;
+    grb[2] = seg->chunk[idx].b;
+  }
+  else {
+    expandPixel(p, grb);
+  }
+
+  return;
+}
+
+static uint8_t nextByte(segmentState *seg)
+{
+  // Reversed segments walk the logical pixels backwards, but each pixel's bytes stay in wire order
+  uint8_t byteval;
+
+  if (seg->byteInPixel == 0) {
+    fetchPixel(seg, seg->pixBytes);
+  }
+  byteval = seg->pixBytes[seg->byteInPixel];
+
+  if (++seg->byteInPixel == 3) {
+    seg->byteInPixel = 0;
+    seg->pixel += seg->step;
+  }
+
+  return ws2812_brightnessLUT[byteval];
+}
+
+uint32_t ws2812_supplyChunk(int segment, uint8_t *dst, uint32_t maxBytes)
+{
+  segmentState *seg = &ws2812_segs[segment];
+  uint32_t i, len = seg->len - seg->pos;
+
+  if (len > maxBytes)
+    len = maxBytes;
+
+  for (i = 0; i < len; i++) {
+    dst[i] = nextByte(seg);
+  }
+  seg->pos += len;
+
+  return len;
+}
+
+static void addToSums(uint32_t index, int sign)
+{
+  uint8_t grb[3];
+
+  if (ws2812_format == FORMAT_INDEXED8) {
+    ws2812_indexCounts[ws2812_buffer[index]] += sign;
+    return;
+  }
+  expandPixel(index, grb);
+  ws2812_sums[0] += sign * (int64_t) grb[1];
+  ws2812_sums[1] += sign * (int64_t) grb[0];
+  ws2812_sums[2] += sign * (int64_t) grb[2];
+
+  return;
+}
+
+static void recountSums()
+{
+  uint32_t i;
+
+  ws2812_sums[0] = ws2812_sums[1] = ws2812_sums[2] = 0;
+  memset(ws2812_indexCounts, 0, sizeof(ws2812_indexCounts));
+  for (i = 0; i < ws2812_numPixels; i++) {
+    addToSums(i, 1);
+  }
+
+  return;
+}
+
+static void clearPixel(uint32_t index)
+{
+  switch (ws2812_format) {
+    case FORMAT_GRB888:
+      ((grbVal *) ws2812_buffer)[index] = makeGRBVal(0, 0, 0);
+      break;
+    case FORMAT_RGB565:
+      ((uint16_t *) ws2812_buffer)[index] = 0;
+      break;
+    case FORMAT_PLANAR:
+      ws2812_buffer[PLANE_R * ws2812_bufferCapacity + index] = 0;
+      ws2812_buffer[PLANE_G * ws2812_bufferCapacity + index] = 0;
+      ws2812_buffer[PLANE_B * ws2812_bufferCapacity + index] = 0;
+      break;
+    case FORMAT_INDEXED8:
+      ws2812_buffer[index] = 0;
+      break;
+  }
+
+  return;
+}
+
+static uint64_t estimateMicroAmps(uint8_t level)
+{
+  uint64_t sums[3] = {ws2812_sums[0], ws2812_sums[1], ws2812_sums[2]};
+  int i;
+
+  if (ws2812_format == FORMAT_INDEXED8) {
+    // Palette changes cost 256 steps here rather than a pass over the pixels
+    sums[0] = sums[1] = sums[2] = 0;
+    for (i = 0; i < WS2812_PALETTE_SIZE; i++) {
+      sums[0] += (uint64_t) ws2812_indexCounts[i] * ws2812_palette[i].r;
+      sums[1] += (uint64_t) ws2812_indexCounts[i] * ws2812_palette[i].g;
+      sums[2] += (uint64_t) ws2812_indexCounts[i] * ws2812_palette[i].b;
+    }
+  }
+
+  return (uint64_t) ws2812_power.idle * ws2812_numPixels +
+         (sums[0] * ws2812_power.red + sums[1] * ws2812_power.green + sums[2] * ws2812_power.blue) / 255 * level / 255;
+}
+
+static void applyPowerLimit()
+{
+  // Scale the whole frame through the brightness LUT - dark LEDs still draw their idle current
+  uint8_t level = ws2812_brightness;
+
+  if (ws2812_powerBudget) {
+    uint64_t budget = (uint64_t) ws2812_powerBudget * 1000;
+    uint64_t idle = (uint64_t) ws2812_power.idle * ws2812_numPixels;
+    uint64_t estimate;
+
+    // Writes through a raw pointer are invisible to setPixel(), so once one has been handed
+    // out every frame is re-summed - a missed write here would let the frame through unlimited
+    if (ws2812_sumsStale) {
+      recountSums();
+    }
+    estimate = estimateMicroAmps(ws2812_brightness);
+    if (estimate > budget) {
+      level = (budget <= idle) ? 0 : (uint8_t) (ws2812_brightness * (budget - idle) / (estimate - idle));
+    }
+  }
+
+  if (level != ws2812_level) {
+    buildBrightnessLUT(level);
+  }
+
+  return;
+}
+
+void ws2812_setPowerBudget(uint32_t milliamps)
+{
+  ws2812_powerBudget = milliamps;
+
+  return;
+}
+
+uint32_t ws2812_getEstimatedCurrent()
+{
+  if (ws2812_sumsStale) {
+    recountSums();
+  }
+
+  return estimateMicroAmps(ws2812_level) / 1000;
+}
+
+int ws2812_setFormat(int format)
+{
+  switch (format) {
+    case FORMAT_GRB888:
+    case FORMAT_RGB565:
+    case FORMAT_PLANAR:
+    case FORMAT_INDEXED8:
+      break;
+    default:
+      return -1;
+  }
+
+  if (format != ws2812_format) {
+    ws2812_waitComplete();
+    free(ws2812_buffer);
+    ws2812_buffer = NULL;
+    ws2812_bufferCapacity = 0;
+    ws2812_numPixels = 0;
+    ws2812_format = format;
+    ws2812_sums[0] = ws2812_sums[1] = ws2812_sums[2] = 0;
+    memset(ws2812_indexCounts, 0, sizeof(ws2812_indexCounts));
+    ws2812_sumsStale = 0;
+  }
+
+  return 0;
+}
+
+int ws2812_setLength(uint32_t length)
+{
+  // The channel sums cover exactly the pixels in use: pixels cut off are taken out of them
+  // and cleared, and pixels beyond the length are always black when they come back into use
+  uint32_t oldCapacity = ws2812_bufferCapacity;
+  uint32_t i;
+
+  // Clearing or moving the buffer under a frame that is still being sent would corrupt it
+  ws2812_waitComplete();
+
+  for (i = length; i < ws2812_numPixels; i++) {
+    addToSums(i, -1);
+    clearPixel(i);
+  }
+
+  if (length > oldCapacity) {
+    uint32_t bytesPerPixel = (ws2812_format == FORMAT_RGB565) ? 2 : (ws2812_format == FORMAT_INDEXED8) ? 1 : 3;
+    uint8_t *buffer;
+
+    // Byte offsets into the buffer are 32-bit, so that limit applies even where size_t is wider
+    if (length > SIZE_MAX / bytesPerPixel || length > UINT32_MAX / bytesPerPixel) {
+      return -1;
+    }
+    buffer = (uint8_t *) realloc(ws2812_buffer, ((size_t) length * bytesPerPixel) * sizeof(uint8_t));
+    if (!buffer) {
+      return -1;
+    }
+    if (ws2812_format == FORMAT_PLANAR) {
+      // Planes are spaced by the capacity, so move the upper ones out to their new places
+      memmove(buffer + PLANE_B * length, buffer + PLANE_B * oldCapacity, oldCapacity);
+      memmove(buffer + PLANE_G * length, buffer + PLANE_G * oldCapacity, oldCapacity);
+      memset(buffer + PLANE_R * length + oldCapacity, 0, length - oldCapacity);
+      memset(buffer + PLANE_G * length + oldCapacity, 0, length - oldCapacity);
+      memset(buffer + PLANE_B * length + oldCapacity, 0, length - oldCapacity);
+    }
+    else {
+      memset(buffer + oldCapacity * bytesPerPixel, 0, (length - oldCapacity) * bytesPerPixel);
+    }
+    ws2812_buffer = buffer;
+    ws2812_bufferCapacity = length;
+  }
+  if (ws2812_format == FORMAT_INDEXED8 && length > ws2812_numPixels) {
+    ws2812_indexCounts[0] += length - ws2812_numPixels;
+  }
+  ws2812_numPixels = length;
+
+  return 0;
+}
+
+void *ws2812_getBuffer(uint32_t length)
+{
+  if (ws2812_setLength(length)) {
+    return NULL;
+  }
+  ws2812_sumsStale = 1;
+
+  return ws2812_buffer;
+}
+
+grbVal *ws2812_getPixels(uint32_t length)
+{
+  if (ws2812_format != FORMAT_GRB888) {
+    return NULL;
+  }
+
+  return (grbVal *) ws2812_getBuffer(length);
+}
+
+uint8_t *ws2812_getPlane(int plane)
+{
+  if (ws2812_format != FORMAT_PLANAR || !ws2812_buffer) {
+    return NULL;
+  }
+  ws2812_sumsStale = 1;
+
+  return ws2812_buffer + plane * ws2812_bufferCapacity;
+}
+
+rgbVal *ws2812_getPalette()
+{
+  return ws2812_palette;
+}
+
+static uint8_t nearestPaletteIndex(rgbVal color)
+{
+  uint32_t best = 0, bestDist = UINT32_MAX;
+  int i;
+
+  for (i = 0; i < WS2812_PALETTE_SIZE && bestDist; i++) {
+    int dr = color.r - ws2812_palette[i].r;
+    int dg = color.g - ws2812_palette[i].g;
+    int db = color.b - ws2812_palette[i].b;
+    uint32_t dist = dr * dr + dg * dg + db * db;
+    if (dist < bestDist) {
+      best = i;
+      bestDist = dist;
+    }
+  }
+
+  return best;
+}
+
+void ws2812_setPixel(uint32_t index, rgbVal color)
+{
+  if (index >= ws2812_numPixels) {
+    return;
+  }
+  addToSums(index, -1);
+
+  switch (ws2812_format) {
+    case FORMAT_GRB888:
+      ((grbVal *) ws2812_buffer)[index] = makeGRBVal(color.r, color.g, color.b);
+      break;
+    case FORMAT_RGB565:
+      ((uint16_t *) ws2812_buffer)[index] = makeRGB565(color.r, color.g, color.b);
+      break;
+    case FORMAT_PLANAR:
+      ws2812_buffer[PLANE_R * ws2812_bufferCapacity + index] = color.r;
+      ws2812_buffer[PLANE_G * ws2812_bufferCapacity + index] = color.g;
+      ws2812_buffer[PLANE_B * ws2812_bufferCapacity + index] = color.b;
+      break;
+    case FORMAT_INDEXED8:
+      ws2812_buffer[index] = nearestPaletteIndex(color);
+      break;
+  }
+
+  addToSums(index, 1);
+
+  return;
+}
+
+rgbVal ws2812_getPixel(uint32_t index)
+{
+  uint8_t grb[3];
+
+  if (index >= ws2812_numPixels || !ws2812_buffer) {
+    return makeRGBVal(0, 0, 0);
+  }
+
+  // Reuse the encoder's expansion so reads see exactly what would be sent
+  expandPixel(index, grb);
+
+  return makeRGBVal(grb[1], grb[0], grb[2]);
+}
+
+void ws2812_setColors(uint32_t length, rgbVal *array)
+{
+  uint32_t i;
+
+  if (ws2812_setLength(length)) {
+    return;
+  }
+
+  for (i = 0; i < length; i++) {
+    // Where color order is translated from RGB (e.g., WS2812 = GRB)
+    ws2812_setPixel(i, array[i]);
+  }
+
+  ws2812_show();
+
+  return;
+}
+
+void ws2812_show()
+{
+  ws2812_waitComplete();
+  ws2812_source = NULL;
+  applyPowerLimit();
+  transmit(ws2812_numPixels);
+
+  return;
+}
+
+void ws2812_prepare()
+{
+  ws2812_waitComplete();
+  ws2812_source = NULL;
+  applyPowerLimit();
+  beginTransmit(ws2812_numPixels);
+
+  return;
+}
+
+void ws2812_start()
+{
+  if (ws2812_backendImpl) {
+    ws2812_backendImpl->startFrame();
+    ws2812_inFlight = 1;
+  }
+
+  return;
+}
+
+void ws2812_waitComplete()
+{
+  if (ws2812_backendImpl && ws2812_inFlight) {
+    ws2812_backendImpl->waitComplete();
+    ws2812_inFlight = 0;
+  }
+
+  return;
+}
+
+void ws2812_showSource(uint32_t length, ws2812_pixelSource source, void *arg)
+{
+  ws2812_waitComplete();
+
+  // Streamed frames are not limited, so drop any limit left over from the last framebuffer frame
+  if (ws2812_level != ws2812_brightness) {
+    buildBrightnessLUT(ws2812_brightness);
+  }
+  ws2812_source = source;
+  ws2812_sourceArg = arg;
+  transmit(length);
+  ws2812_source = NULL;
+
+  return;
+}
+
+static void transmit(uint32_t length)
+{
+  beginTransmit(length);
+  ws2812_start();
+  ws2812_waitComplete();
+
+  return;
+}
+
+static void beginTransmit(uint32_t length)
+{
+  uint32_t segmentBytes[WS2812_MAX_SEGMENTS];
+  int i;
+
+  if (!ws2812_backendImpl) {
+    return;
+  }
+
+  for (i = 0; i < ws2812_numSegs; i++) {
+    segmentState *seg = &ws2812_segs[i];
+    uint32_t txCount = 0;
+
+    if (length > seg->start) {
+      txCount = length - seg->start;
+      if (txCount > seg->count)
+        txCount = seg->count;
+    }
+
+    seg->len = txCount * 3;
+    seg->pos = 0;
+    seg->byteInPixel = 0;
+    seg->step = seg->reversed ? -1 : 1;
+    seg->pixel = seg->reversed ? seg->start + txCount - 1 : seg->start;
+    seg->chunkStart = seg->chunkLen = 0;
+    segmentBytes[i] = seg->len;
+  }
+
+  ws2812_backendImpl->beginFrame(segmentBytes, ws2812_numSegs);
+
+  return;
+}
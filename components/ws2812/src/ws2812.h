@@ -0,0 +1,195 @@
+/*
+ * A driver for the WS2812 RGB LEDs using the RMT peripheral on the ESP32.
+ *
+ * Modifications Copyright (c) 2017 Martin F. Falatic
+ *
+ * Based on public domain code created 19 Nov 2016 by Chris Osborn <fozztexx@fozztexx.com>
+ * http://insentricity.com
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef WS2812_DRIVER_H
+#define WS2812_DRIVER_H
+
+#include <stdint.h>
+
+typedef union {
+  struct __attribute__ ((packed)) {
+    uint8_t r, g, b;
+  };
+  uint32_t num;
+} rgbVal;
+
+/* One pixel as it goes out on the wire (WS2812-class parts are GRB) */
+typedef struct __attribute__ ((packed)) {
+  uint8_t g, r, b;
+} grbVal;
+
+#define DEBUG_WS2812_DRIVER 0
+
+#if DEBUG_WS2812_DRIVER
+extern char * ws2812_debugBuffer;
+const int     ws2812_debugBufferSz = 1024;
+#endif
+
+#define WS2812_MAX_SEGMENTS 8 /* One per RMT channel */
+
+/*
+ * A logical strip may be split into up to WS2812_MAX_SEGMENTS physical
+ * segments, each on its own GPIO and RMT channel (backends other than the
+ * RMT ignore gpioNum and rmtChannel). Segments take consecutive
+ * runs of the logical pixel array, in the order given, and are transmitted
+ * in parallel. A reversed segment is fed from its far end, so its first pixel
+ * on the wire is the last logical pixel of the run.
+ */
+typedef struct {
+  int      gpioNum;
+  int      rmtChannel;
+  uint32_t length;
+  int      reversed;
+} ws2812_segment;
+
+/* One-wire parts are driven by the RMT; clocked parts (data + clock) by SPI DMA */
+enum led_types {LED_WS2812, LED_WS2812B, LED_SK6812, LED_WS2813, LED_APA102, LED_SK9822};
+extern int  ws2812_init(int gpioNum, int ledType);
+extern int  ws2812_initStrip(const ws2812_segment *segments, int numSegments, int ledType);
+extern int  ws2812_initClocked(int dataGpio, int clockGpio, uint32_t length, int ledType, uint32_t clockHz);
+extern void ws2812_setColors(uint32_t length, rgbVal *array);
+
+/*
+ * Global brightness, 0-255 (default 255). One-wire parts scale each colour
+ * byte; clocked parts use the 5-bit per-pixel brightness field first, which
+ * keeps full colour resolution at low levels.
+ */
+extern void ws2812_setBrightness(uint8_t brightness);
+
+/*
+ * Power limiting: the driver estimates each frame's current from per-channel
+ * totals and the LED type's current model, and if it is over budget (in mA,
+ * 0 for no limit) scales the frame by lowering the brightness above for that
+ * frame. The totals are kept up to date by ws2812_setPixel() (and the palette
+ * counts in FORMAT_INDEXED8), so checking costs nothing per pixel. The driver
+ * cannot see writes through a raw pointer, so once one has been handed out by
+ * ws2812_getPixels(), ws2812_getBuffer() or ws2812_getPlane() it re-sums the
+ * whole framebuffer before every frame while a budget is set (until the next
+ * ws2812_setFormat() change); use ws2812_setPixel() to keep the check free.
+ * Frames from ws2812_showSource() are not limited, and are sent at the
+ * brightness set with ws2812_setBrightness().
+ */
+extern void     ws2812_setPowerBudget(uint32_t milliamps);
+extern uint32_t ws2812_getEstimatedCurrent();
+
+/*
+ * Zero-copy access: ws2812_getPixels() returns the driver's own wire-order
+ * buffer sized for length pixels, and ws2812_show() transmits it as is. The
+ * buffer must not be written while a transmission is in progress. It moves
+ * (so the pointer must be fetched again) whenever the framebuffer grows past
+ * the largest length so far - through ws2812_getPixels(), ws2812_getBuffer(),
+ * ws2812_setLength(), ws2812_setColors() or the modules built on them (e.g.
+ * ws2812_effectsInit(), ws2812_submitInit(), the compositor and sync client) -
+ * and is freed by any ws2812_setFormat() that changes the format.
+ */
+extern grbVal *ws2812_getPixels(uint32_t length);
+extern void    ws2812_show();
+
+/*
+ * ws2812_show() split in three, for starting a frame at a precise time:
+ * ws2812_prepare() encodes as much of the framebuffer as the output allows
+ * ahead of time, ws2812_start() puts it on the wire, and
+ * ws2812_waitComplete() blocks until it has been sent. Until then the driver
+ * treats the frame as in flight: ws2812_setLength() and the calls built on it,
+ * ws2812_setFormat(), ws2812_show(), ws2812_prepare() and ws2812_showSource()
+ * first wait for it to finish. ws2812_setPixel() does not wait, so writes
+ * made meanwhile may tear the frame being sent.
+ */
+extern void    ws2812_prepare();
+extern void    ws2812_start();
+extern void    ws2812_waitComplete();
+
+/*
+ * Framebuffer formats, expanded to wire bytes as each pixel is sent:
+ *   FORMAT_GRB888 - 3 bytes per pixel in wire order (default, see ws2812_getPixels())
+ *   FORMAT_RGB565 - one uint16_t per pixel (see makeRGB565())
+ *   FORMAT_PLANAR - separate R, G and B planes of one byte per pixel (see ws2812_getPlane())
+ *   FORMAT_INDEXED8 - one byte per pixel indexing the palette from ws2812_getPalette()
+ * Changing the format discards the framebuffer. ws2812_setLength() sizes it
+ * for length pixels (new pixels are black) and ws2812_getBuffer() does the
+ * same and returns it, like ws2812_getPixels(); ws2812_setPixel() and
+ * ws2812_getPixel() work in any format. ws2812_setPixel() ignores indices at
+ * or past the length and ws2812_getPixel() returns black for them, and
+ * shrinking the length clears the pixels cut off.
+ */
+enum pixel_formats {FORMAT_GRB888, FORMAT_RGB565, FORMAT_PLANAR, FORMAT_INDEXED8};
+enum pixel_planes {PLANE_R, PLANE_G, PLANE_B};
+extern int      ws2812_setFormat(int format);
+extern int      ws2812_setLength(uint32_t length);
+extern void    *ws2812_getBuffer(uint32_t length);
+extern uint8_t *ws2812_getPlane(int plane);
+extern void     ws2812_setPixel(uint32_t index, rgbVal color);
+extern rgbVal   ws2812_getPixel(uint32_t index);
+
+/*
+ * The palette for FORMAT_INDEXED8 (initially all black). Entries may be
+ * changed at any time between frames, so colour cycling costs 256 writes
+ * rather than a re-render. In this format ws2812_setPixel() has to search
+ * for the nearest palette entry - write indices into ws2812_getBuffer()
+ * instead where speed matters.
+ */
+#define WS2812_PALETTE_SIZE 256
+extern rgbVal *ws2812_getPalette();
+
+/*
+ * Streaming: instead of a framebuffer, the driver pulls pixels from a source
+ * callback in chunks of up to WS2812_SOURCE_CHUNK as each segment's output
+ * drains. The callback fills count pixels starting at logical pixel start;
+ * with the RMT it runs in interrupt context, so it must be short and must not
+ * block.
+ */
+#define WS2812_SOURCE_CHUNK 16
+
+typedef void (*ws2812_pixelSource)(uint32_t start, uint32_t count, rgbVal *pixels, void *arg);
+extern void ws2812_showSource(uint32_t length, ws2812_pixelSource source, void *arg);
+
+inline rgbVal makeRGBVal(uint8_t r, uint8_t g, uint8_t b)
+{
+  rgbVal v;
+  v.r = r;
+  v.g = g;
+  v.b = b;
+  return v;
+}
+
+inline grbVal makeGRBVal(uint8_t r, uint8_t g, uint8_t b)
+{
+  grbVal v;
+  v.g = g;
+  v.r = r;
+  v.b = b;
+  return v;
+}
+
+inline uint16_t makeRGB565(uint8_t r, uint8_t g, uint8_t b)
+{
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+#endif /* WS2812_DRIVER_H */
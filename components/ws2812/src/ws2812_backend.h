@@ -0,0 +1,66 @@
+/* 
+ * Output backend interface for the digital RGB LED driver.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ * The core (ws2812.cpp) owns the pixels and encodes them to wire-order bytes;
+ * a backend moves those bytes to the LEDs. A backend is told how many bytes
+ * each segment will send when a frame begins, then pulls them in whatever
+ * chunk size suits it with ws2812_supplyChunk() - from an interrupt for the
+ * RMT, or straight away for the host backends. beginFrame should do as much
+ * of that as it can up front, so that startFrame can put the frame on the
+ * wire at a precise moment.
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef WS2812_BACKEND_H
+#define WS2812_BACKEND_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "ws2812.h"
+
+typedef struct {
+  const char *name;
+  int  handlesBrightness;  /* Non-zero if the backend applies ws2812_getBrightness() itself */
+  void (*beginFrame)(const uint32_t *segmentBytes, int numSegments);
+  void (*startFrame)();
+  void (*waitComplete)();
+} ws2812_backend;
+
+/* Core side: select a backend for a strip, and feed it encoded bytes */
+extern int      ws2812_useBackend(const ws2812_backend *backend, const ws2812_segment *segments, int numSegments);
+extern uint32_t ws2812_supplyChunk(int segment, uint8_t *dst, uint32_t maxBytes);
+extern uint8_t  ws2812_getBrightness();  /* After power limiting */
+extern void     ws2812_setLedType(int ledType); /* Selects the current model for power limiting */
+
+/* Encodes every frame and throws it away, for measuring render and encode throughput */
+extern const ws2812_backend ws2812_nullBackend;
+
+/*
+ * Writes every frame to out for offline inspection: for each segment in
+ * order, a little-endian uint32_t byte count followed by the GRB bytes.
+ */
+extern int ws2812_initFile(FILE *out, const ws2812_segment *segments, int numSegments);
+
+#endif /* WS2812_BACKEND_H */
@@ -0,0 +1,210 @@
+/* 
+ * Layered compositor for the digital RGB LED driver.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ * Blending works on whole packed pixels at once (see ws2812_swar.h).
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "ws2812_compositor.h"
+#include "ws2812_swar.h"
+
+#include <stdlib.h>
+
+typedef struct {
+  uint32_t *pixels;
+  int       mode;
+  uint8_t   opacity;
+  uint32_t  dirtyStart, dirtyEnd;   // Empty when dirtyStart >= dirtyEnd
+} layerState;
+
+static layerState comp_layers[WS2812_MAX_LAYERS];
+static int comp_numLayers = 0;
+static uint32_t comp_length = 0;
+
+int ws2812_compositorInit(int numLayers, uint32_t length)
+{
+  int i;
+
+  if (numLayers < 1 || numLayers > WS2812_MAX_LAYERS) {
+    return -1;
+  }
+
+  for (i = 0; i < comp_numLayers; i++) {
+    free(comp_layers[i].pixels);
+    comp_layers[i].pixels = NULL;
+  }
+  comp_numLayers = 0;
+
+  for (i = 0; i < numLayers; i++) {
+    comp_layers[i].pixels = (uint32_t *) calloc(length, sizeof(uint32_t));
+    if (!comp_layers[i].pixels) {
+      comp_numLayers = i;
+      return -1;
+    }
+    comp_layers[i].mode = BLEND_NORMAL;
+    comp_layers[i].opacity = 255;
+    comp_layers[i].dirtyStart = 0;
+    comp_layers[i].dirtyEnd = length;
+  }
+  comp_numLayers = numLayers;
+  comp_length = length;
+
+  return 0;
+}
+
+void ws2812_layerSetBlend(int layer, int mode, uint8_t opacity)
+{
+  if (layer < 0 || layer >= comp_numLayers) {
+    return;
+  }
+  comp_layers[layer].mode = mode;
+  comp_layers[layer].opacity = opacity;
+  ws2812_layerMarkDirty(layer, 0, comp_length);
+
+  return;
+}
+
+uint32_t *ws2812_layerPixels(int layer)
+{
+  return (layer >= 0 && layer < comp_numLayers) ? comp_layers[layer].pixels : NULL;
+}
+
+void ws2812_layerMarkDirty(int layer, uint32_t start, uint32_t end)
+{
+  layerState *l;
+
+  if (layer < 0 || layer >= comp_numLayers) {
+    return;
+  }
+  l = &comp_layers[layer];
+  if (end > comp_length) {
+    end = comp_length;
+  }
+  if (start >= end) {
+    return;
+  }
+  if (l->dirtyStart >= l->dirtyEnd) {
+    l->dirtyStart = start;
+    l->dirtyEnd = end;
+  }
+  else {
+    if (start < l->dirtyStart) l->dirtyStart = start;
+    if (end > l->dirtyEnd) l->dirtyEnd = end;
+  }
+
+  return;
+}
+
+void ws2812_layerSetPixel(int layer, uint32_t index, uint32_t argb)
+{
+  if (layer < 0 || layer >= comp_numLayers || index >= comp_length) {
+    return;
+  }
+  comp_layers[layer].pixels[index] = argb;
+  ws2812_layerMarkDirty(layer, index, index + 1);
+
+  return;
+}
+
+static inline uint32_t addSaturateRGB(uint32_t dst, uint32_t src)
+{
+  // Sums carry into bit 8 of each lane; turn every carry into an all-ones byte
+  uint32_t rb = (dst & RB_MASK) + (src & RB_MASK);
+  uint32_t g  = (dst & G_MASK) + (src & G_MASK);
+  uint32_t rbCarry = rb & 0x01000100;
+
+  rb |= rbCarry - (rbCarry >> 8);
+  if (g & 0x00010000) {
+    g = G_MASK;
+  }
+
+  return (rb & RB_MASK) | (g & G_MASK);
+}
+
+static inline uint32_t multiplyRGB(uint32_t dst, uint32_t src)
+{
+  // Multiplying lane by lane needs each byte of src on its own; (x * y + 255) >> 8 keeps 255 * 255 at 255
+  uint32_t r = ((((dst >> 16) & 0xFF) * ((src >> 16) & 0xFF) + 255) >> 8);
+  uint32_t g = ((((dst >> 8) & 0xFF) * ((src >> 8) & 0xFF) + 255) >> 8);
+  uint32_t b = (((dst & 0xFF) * (src & 0xFF) + 255) >> 8);
+
+  return (r << 16) | (g << 8) | b;
+}
+
+static inline uint32_t blendPixel(uint32_t dst, uint32_t src, int mode, uint32_t opacity)
+{
+  // Effective alpha, stretched from 0-255 to 0-256 so full opacity copies exactly
+  uint32_t a = ((src >> 24) * opacity + 255) >> 8;
+  a += a >> 7;
+
+  if (!a) {
+    return dst;
+  }
+
+  switch (mode) {
+    case BLEND_ADD:
+      return addSaturateRGB(dst, scaleRGB(src, a));
+    case BLEND_MULTIPLY:
+      return lerpRGB(dst, multiplyRGB(dst, src), a);
+    case BLEND_SCREEN:
+      return lerpRGB(dst, ~multiplyRGB(~dst, ~src) & 0x00FFFFFF, a);
+    case BLEND_NORMAL:
+    default:
+      return lerpRGB(dst, src, a);
+  }
+}
+
+int ws2812_composite()
+{
+  uint32_t start = UINT32_MAX, end = 0, i;
+  int l;
+
+  for (l = 0; l < comp_numLayers; l++) {
+    if (comp_layers[l].dirtyStart < comp_layers[l].dirtyEnd) {
+      if (comp_layers[l].dirtyStart < start) start = comp_layers[l].dirtyStart;
+      if (comp_layers[l].dirtyEnd > end) end = comp_layers[l].dirtyEnd;
+    }
+  }
+  if (start >= end || ws2812_setLength(comp_length)) {
+    return 0;
+  }
+
+  for (i = start; i < end; i++) {
+    uint32_t acc = 0;
+    for (l = 0; l < comp_numLayers; l++) {
+      if (comp_layers[l].opacity) {
+        acc = blendPixel(acc, comp_layers[l].pixels[i], comp_layers[l].mode, comp_layers[l].opacity);
+      }
+    }
+    // Straight into the framebuffer, keeping the power estimate current as it goes
+    ws2812_setPixel(i, makeRGBVal(acc >> 16, acc >> 8, acc));
+  }
+
+  for (l = 0; l < comp_numLayers; l++) {
+    comp_layers[l].dirtyStart = comp_layers[l].dirtyEnd = 0;
+  }
+
+  return 1;
+}
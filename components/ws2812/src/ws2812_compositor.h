@@ -0,0 +1,70 @@
+/* 
+ * Layered compositor for the digital RGB LED driver.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ * Layers hold packed 0xAARRGGBB pixels and are stacked bottom (layer 0) to
+ * top over black. Each layer has a blend mode, an opacity and a dirty range;
+ * ws2812_composite() blends only the pixels that some layer has changed and
+ * writes the result straight into the driver's framebuffer in one pass.
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef WS2812_COMPOSITOR_H
+#define WS2812_COMPOSITOR_H
+
+#include <stdint.h>
+#include "ws2812.h"
+
+#define WS2812_MAX_LAYERS 8
+
+enum blend_modes {BLEND_NORMAL, BLEND_ADD, BLEND_MULTIPLY, BLEND_SCREEN};
+
+inline uint32_t makeARGB(uint8_t a, uint8_t r, uint8_t g, uint8_t b)
+{
+  return ((uint32_t) a << 24) | ((uint32_t) r << 16) | ((uint32_t) g << 8) | b;
+}
+
+/* Allocates numLayers transparent layers of length pixels, replacing any previous set */
+extern int       ws2812_compositorInit(int numLayers, uint32_t length);
+
+/*
+ * Opacity (0-255) scales each pixel's own alpha; a layer at opacity 0 is
+ * skipped entirely. Changing the mode or opacity marks the whole layer dirty.
+ */
+extern void      ws2812_layerSetBlend(int layer, int mode, uint8_t opacity);
+
+/*
+ * Direct access to a layer's pixels. Writes through the pointer must be
+ * followed by ws2812_layerMarkDirty() for the range [start, end) they touched;
+ * ws2812_layerSetPixel() does that itself. Out-of-range layers and pixel
+ * indices are ignored (ws2812_layerPixels() returns NULL for them).
+ */
+extern uint32_t *ws2812_layerPixels(int layer);
+extern void      ws2812_layerMarkDirty(int layer, uint32_t start, uint32_t end);
+extern void      ws2812_layerSetPixel(int layer, uint32_t index, uint32_t argb);
+
+/* Blends the dirty pixels into the framebuffer; returns 0 if nothing had changed */
+extern int       ws2812_composite();
+
+#endif /* WS2812_COMPOSITOR_H */
@@ -0,0 +1,233 @@
+/* 
+ * Cooperative effect scheduler for the digital RGB LED driver.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ * During a crossfade the outgoing effect keeps running into a second buffer,
+ * and the two are blended as they are copied into the framebuffer.
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "ws2812_effects.h"
+#include "ws2812_swar.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  uint32_t start, count, frameMs;
+  ws2812_playlistEntry entries[WS2812_MAX_PLAYLIST];
+  int      numEntries, loop;
+  int      current, previous;     // previous is -1 unless fading
+  int      started, dirty;
+  uint32_t entryStartMs, nextFrameMs;
+  uint32_t frame, previousFrame;
+  rgbVal  *pixels, *fadePixels;   // Current effect, outgoing effect
+} strandState;
+
+static strandState effects_strands[WS2812_MAX_STRANDS];
+static int effects_numStrands = 0;
+static uint32_t effects_length = 0;
+
+int ws2812_effectsInit(uint32_t length)
+{
+  int i;
+
+  ws2812_waitComplete();
+  for (i = 0; i < effects_numStrands; i++) {
+    free(effects_strands[i].pixels);
+    free(effects_strands[i].fadePixels);
+  }
+  memset(effects_strands, 0, sizeof(effects_strands));
+  effects_numStrands = 0;
+  effects_length = length;
+
+  return ws2812_setLength(length);
+}
+
+int ws2812_strandAdd(uint32_t start, uint32_t count, uint32_t frameMs)
+{
+  strandState *strand;
+
+  if (effects_numStrands >= WS2812_MAX_STRANDS || !count || start > effects_length || count > effects_length - start) {
+    return -1;
+  }
+
+  strand = &effects_strands[effects_numStrands];
+  strand->pixels = (rgbVal *) calloc(count, sizeof(rgbVal));
+  strand->fadePixels = (rgbVal *) calloc(count, sizeof(rgbVal));
+  if (!strand->pixels || !strand->fadePixels) {
+    free(strand->pixels);
+    free(strand->fadePixels);
+    strand->pixels = strand->fadePixels = NULL;
+    return -1;
+  }
+  strand->start = start;
+  strand->count = count;
+  strand->frameMs = frameMs;
+  strand->numEntries = 0;
+
+  return effects_numStrands++;
+}
+
+int ws2812_strandPlay(int strand, const ws2812_playlistEntry *entries, int numEntries, int loop)
+{
+  strandState *s;
+
+  if (strand < 0 || strand >= effects_numStrands || numEntries < 1) {
+    return -1;
+  }
+
+  s = &effects_strands[strand];
+  if (numEntries > WS2812_MAX_PLAYLIST) {
+    numEntries = WS2812_MAX_PLAYLIST;
+  }
+  memcpy(s->entries, entries, numEntries * sizeof(ws2812_playlistEntry));
+  s->numEntries = numEntries;
+  s->loop = loop;
+  s->current = 0;
+  s->previous = -1;
+  s->frame = 0;
+  s->started = 0;
+  memset(s->pixels, 0, s->count * sizeof(rgbVal));
+
+  return 0;
+}
+
+static void advanceEntry(strandState *s, uint32_t nowMs)
+{
+  const ws2812_playlistEntry *entry = &s->entries[s->current];
+  int next;
+
+  if (entry->durationMs && nowMs - s->entryStartMs >= entry->durationMs) {
+    next = s->current + 1;
+    if (next >= s->numEntries) {
+      next = s->loop ? 0 : s->current;
+    }
+    if (next != s->current) {
+      // The outgoing effect keeps its buffer and carries on in the fade slot
+      if (s->entries[next].fadeMs) {
+        rgbVal *swap = s->fadePixels;
+        s->fadePixels = s->pixels;
+        s->pixels = swap;
+        s->previous = s->current;
+        s->previousFrame = s->frame;
+      }
+      else {
+        s->previous = -1;
+      }
+      s->current = next;
+      s->frame = 0;
+      s->entryStartMs = nowMs;
+      memset(s->pixels, 0, s->count * sizeof(rgbVal));
+    }
+    else if (s->loop) {
+      // A single looping entry just restarts
+      s->frame = 0;
+      s->entryStartMs = nowMs;
+      memset(s->pixels, 0, s->count * sizeof(rgbVal));
+    }
+  }
+
+  if (s->previous >= 0 && nowMs - s->entryStartMs >= s->entries[s->current].fadeMs) {
+    s->previous = -1;
+  }
+
+  return;
+}
+
+static void copyStrand(strandState *s, uint32_t nowMs)
+{
+  uint32_t i;
+
+  if (s->previous >= 0) {
+    uint32_t fadeMs = s->entries[s->current].fadeMs;
+    uint32_t a = ((nowMs - s->entryStartMs) * 256) / fadeMs;
+    rgbVal color;
+    for (i = 0; i < s->count; i++) {
+      color.num = lerpRGB(s->fadePixels[i].num, s->pixels[i].num, a);
+      ws2812_setPixel(s->start + i, color);
+    }
+  }
+  else {
+    for (i = 0; i < s->count; i++) {
+      ws2812_setPixel(s->start + i, s->pixels[i]);
+    }
+  }
+
+  return;
+}
+
+int ws2812_effectsPoll(uint32_t nowMs)
+{
+  int changed = 0, i;
+
+  // Render everything that is due first, while the last frame is still going out
+  for (i = 0; i < effects_numStrands; i++) {
+    strandState *s = &effects_strands[i];
+    const ws2812_playlistEntry *entry;
+
+    if (!s->numEntries) {
+      continue;
+    }
+    if (!s->started) {
+      s->started = 1;
+      s->entryStartMs = nowMs;
+      s->nextFrameMs = nowMs;
+    }
+    if ((int32_t) (nowMs - s->nextFrameMs) < 0) {
+      continue;
+    }
+    // Skip frames rather than bursting to catch up
+    s->nextFrameMs += s->frameMs;
+    if ((int32_t) (nowMs - s->nextFrameMs) >= 0) {
+      s->nextFrameMs = nowMs + s->frameMs;
+    }
+
+    advanceEntry(s, nowMs);
+    entry = &s->entries[s->current];
+    entry->step(s->pixels, s->count, s->frame++, entry->state);
+    if (s->previous >= 0) {
+      entry = &s->entries[s->previous];
+      entry->step(s->fadePixels, s->count, s->previousFrame++, entry->state);
+    }
+    s->dirty = 1;
+    changed = 1;
+  }
+
+  if (!changed) {
+    return 0;
+  }
+
+  ws2812_waitComplete();
+  for (i = 0; i < effects_numStrands; i++) {
+    if (effects_strands[i].dirty) {
+      copyStrand(&effects_strands[i], nowMs);
+      effects_strands[i].dirty = 0;
+    }
+  }
+  ws2812_prepare();
+  ws2812_start();
+
+  return 1;
+}
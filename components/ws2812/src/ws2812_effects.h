@@ -0,0 +1,80 @@
+/* 
+ * Cooperative effect scheduler for the digital RGB LED driver.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ * Effects are step functions that render one frame per call and keep their
+ * own state between calls, so one task can run many of them. A strand is a
+ * range of pixels with a playlist of effects; the scheduler steps every
+ * strand that is due into its private buffer while the previous frame is
+ * still being sent, then copies them into the framebuffer and starts the
+ * next frame.
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+
+#ifndef WS2812_EFFECTS_H
+#define WS2812_EFFECTS_H
+
+#include <stdint.h>
+#include "ws2812.h"
+
+#define WS2812_MAX_STRANDS  16
+#define WS2812_MAX_PLAYLIST 8
+
+/*
+ * Renders frame number frame (0 when the effect starts) into count pixels.
+ * The pixels are cleared before frame 0 and otherwise hold what the effect
+ * last rendered.
+ */
+typedef void (*ws2812_effectStep)(rgbVal *pixels, uint32_t count, uint32_t frame, void *state);
+
+typedef struct {
+  ws2812_effectStep step;
+  void     *state;
+  uint32_t  durationMs;  // 0 to play until the playlist is replaced
+  uint32_t  fadeMs;      // Crossfade in from the previous entry, 0 to cut
+} ws2812_playlistEntry;
+
+/* Sizes the framebuffer for length pixels and removes all strands */
+extern int ws2812_effectsInit(uint32_t length);
+
+/* Returns a strand id for pixels [start, start + count) stepped every frameMs, or -1 */
+extern int ws2812_strandAdd(uint32_t start, uint32_t count, uint32_t frameMs);
+
+/*
+ * Copies up to WS2812_MAX_PLAYLIST entries and starts the first one on the
+ * next poll. Without loop the strand stays on the last entry.
+ */
+extern int ws2812_strandPlay(int strand, const ws2812_playlistEntry *entries, int numEntries, int loop);
+
+/*
+ * Call often with a millisecond clock. Steps the strands that are due and
+ * sends the result; returns 1 if a frame was started, 0 if nothing was due.
+ * It only waits for the remainder of the previous frame's transmission, and
+ * returns with the new frame still being sent; the driver calls that resize,
+ * reformat or send the framebuffer wait for it (see ws2812_waitComplete()).
+ */
+extern int ws2812_effectsPoll(uint32_t nowMs);
+
+#endif /* WS2812_EFFECTS_H */
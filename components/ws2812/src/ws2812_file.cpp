@@ -0,0 +1,82 @@
+/* 
+ * File backend: writes every encoded frame to a file or pipe for offline
+ * inspection. Works on a host as well as on the ESP32.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "ws2812_backend.h"
+
+static FILE *ws2812_file = NULL;
+
+static void fileBeginFrame(const uint32_t *segmentBytes, int numSegments)
+{
+  uint8_t bytes[256];
+  uint32_t len;
+  int seg;
+
+  for (seg = 0; seg < numSegments; seg++) {
+    uint8_t header[4] = {
+      (uint8_t) segmentBytes[seg], (uint8_t) (segmentBytes[seg] >> 8),
+      (uint8_t) (segmentBytes[seg] >> 16), (uint8_t) (segmentBytes[seg] >> 24)
+    };
+    fwrite(header, 1, sizeof(header), ws2812_file);
+    while ((len = ws2812_supplyChunk(seg, bytes, sizeof(bytes))) > 0) {
+      fwrite(bytes, 1, len, ws2812_file);
+    }
+  }
+
+  return;
+}
+
+static void fileStartFrame()
+{
+  // The whole frame was encoded in fileBeginFrame()
+  return;
+}
+
+static void fileWaitComplete()
+{
+  fflush(ws2812_file);
+
+  return;
+}
+
+static const ws2812_backend ws2812_fileBackend = {
+  .name = "file",
+  .handlesBrightness = 0,
+  .beginFrame = fileBeginFrame,
+  .startFrame = fileStartFrame,
+  .waitComplete = fileWaitComplete,
+};
+
+int ws2812_initFile(FILE *out, const ws2812_segment *segments, int numSegments)
+{
+  if (!out) {
+    return -1;
+  }
+  ws2812_file = out;
+
+  return ws2812_useBackend(&ws2812_fileBackend, segments, numSegments);
+}
@@ -0,0 +1,114 @@
+/* 
+ * Temporal interpolation for the digital RGB LED driver.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "ws2812_interp.h"
+#include "ws2812_swar.h"
+
+#include <stdlib.h>
+
+static rgbVal *interp_frames[3] = {NULL, NULL, NULL};  // Older, newer, and the one being rendered
+static int64_t interp_times[2];
+static int interp_numFrames = 0;
+static uint32_t interp_length = 0;
+static uint32_t interp_fraction = 0;                   // 0-256, from older to newer
+
+int ws2812_interpInit(uint32_t length)
+{
+  int i;
+
+  for (i = 0; i < 3; i++) {
+    free(interp_frames[i]);
+    interp_frames[i] = (rgbVal *) calloc(length, sizeof(rgbVal));
+    if (!interp_frames[i]) {
+      return -1;
+    }
+  }
+  interp_length = length;
+  interp_numFrames = 0;
+
+  return 0;
+}
+
+rgbVal *ws2812_interpNextFrame()
+{
+  return interp_frames[2];
+}
+
+void ws2812_interpPushFrame(int64_t timestampUs)
+{
+  // Rotate buffers: the newer frame becomes the older one, and the old older one is reused
+  rgbVal *oldest = interp_frames[0];
+
+  interp_frames[0] = interp_frames[1];
+  interp_frames[1] = interp_frames[2];
+  interp_frames[2] = oldest;
+  interp_times[0] = interp_times[1];
+  interp_times[1] = timestampUs;
+  if (interp_numFrames < 2) {
+    interp_numFrames++;
+  }
+
+  return;
+}
+
+static void interpSource(uint32_t start, uint32_t count, rgbVal *pixels, void *arg)
+{
+  const rgbVal *older = interp_frames[0] + start;
+  const rgbVal *newer = interp_frames[1] + start;
+  uint32_t i;
+
+  for (i = 0; i < count; i++) {
+    pixels[i].num = lerpRGB(older[i].num, newer[i].num, interp_fraction);
+  }
+
+  return;
+}
+
+int ws2812_interpShow(int64_t nowUs)
+{
+  int64_t interval = interp_times[1] - interp_times[0];
+  int64_t elapsed = nowUs - interp_times[1];
+
+  if (!interp_numFrames) {
+    return 0;
+  }
+
+  // One fraction per output frame; the per-pixel blend happens as the encoder pulls pixels
+  if (interp_numFrames < 2 || interval <= 0 || elapsed >= interval) {
+    interp_fraction = 256;
+  }
+  else if (elapsed <= 0) {
+    interp_fraction = 0;
+  }
+  else {
+    interp_fraction = (uint32_t) ((elapsed * 256) / interval);
+  }
+
+  ws2812_showSource(interp_length, interpSource, NULL);
+
+  return 1;
+}
@@ -0,0 +1,53 @@
+/* 
+ * Temporal interpolation: upsamples low-rate content (e.g. 20-30 fps from
+ * the network) to the strip's refresh rate.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ * The two most recent source frames are kept, and each output frame is a
+ * fixed-point blend of them computed per pixel as it is encoded, so there
+ * is no extra pass over a framebuffer. Output lags the source by one source
+ * frame interval: at the timestamp of the newest frame the older one is
+ * shown, and the newest is reached one interval later.
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef WS2812_INTERP_H
+#define WS2812_INTERP_H
+
+#include <stdint.h>
+#include "ws2812.h"
+
+extern int     ws2812_interpInit(uint32_t length);
+
+/*
+ * Render the next source frame into the buffer from ws2812_interpNextFrame(),
+ * then commit it with its timestamp (on the same clock as nowUs below).
+ */
+extern rgbVal *ws2812_interpNextFrame();
+extern void    ws2812_interpPushFrame(int64_t timestampUs);
+
+/* Sends the frame for nowUs; returns 0 until a source frame has been pushed */
+extern int     ws2812_interpShow(int64_t nowUs);
+
+#endif /* WS2812_INTERP_H */
@@ -0,0 +1,443 @@
+/* 
+ * RMT backend: drives WS2812-class RGB LEDs using the RMT peripheral on the ESP32.
+ *
+ * Modifications Copyright (c) 2017 Martin F. Falatic
+ *
+ * Based on public domain code created 19 Nov 2016 by Chris Osborn <fozztexx@fozztexx.com>
+ * http://insentricity.com
+ *
+ * The RMT peripheral on the ESP32 provides very accurate timing of
+ * signals sent to the WS2812 LEDs.
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if defined(ARDUINO) || defined(ESP_PLATFORM)
+
+#include "ws2812.h"
+#include "ws2812_backend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(ARDUINO)
+  #include "esp32-hal.h"
+  #include "esp_intr.h"
+  #include "driver/gpio.h"
+  #include "driver/rmt.h"
+  #include "driver/periph_ctrl.h"
+  #include "freertos/semphr.h"
+  #include "soc/rmt_struct.h"
+#elif defined(ESP_PLATFORM)
+  #include <esp_intr.h>
+  #include <driver/gpio.h>
+  #include <driver/rmt.h>
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/semphr.h>
+  #include <soc/dport_reg.h>
+  #include <soc/gpio_sig_map.h>
+  #include <soc/rmt_struct.h>
+  #include <stdio.h>
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#define DIVIDER             4 /* 8 still seems to work, but timings become marginal */
+#define MAX_PULSES         32 /* A channel has a 64 "pulse" buffer - we use half per pass */
+#define RMT_DURATION_NS  12.5 /* minimum time of a single RMT duration based on clock ns */
+#define RMT_NUM_CHANNELS    8
+
+// Each channel has tx_end at bit 3n and tx_thr_event at bit 24+n of the int_* registers
+#define RMT_INT_TX_END_BIT(ch)       (1U << ((ch) * 3))
+#define RMT_INT_TX_THR_EVENT_BIT(ch) (1U << ((ch) + 24))
+#define RMT_INT_TX_END_MASK          0x00249249
+#define RMT_INT_TX_THR_EVENT_MASK    0xFF000000
+
+// Read pointer into the RMT RAM, in pulses, from a channel's status register
+#define RMT_STATUS_MEM_RADDR(val)    (((val) >> 12) & 0x3FF)
+
+typedef struct {
+  uint32_t T0H;
+  uint32_t T1H;
+  uint32_t T0L;
+  uint32_t T1L;
+  uint32_t TRS;
+} timingParams;
+
+static timingParams ledParams;
+static timingParams ledParams_WS2812  = { .T0H = 350, .T1H = 700, .T0L = 800, .T1L = 600, .TRS =  50000};
+static timingParams ledParams_WS2812B = { .T0H = 350, .T1H = 900, .T0L = 900, .T1L = 350, .TRS =  50000};
+static timingParams ledParams_SK6812  = { .T0H = 300, .T1H = 600, .T0L = 900, .T1L = 600, .TRS =  80000};
+static timingParams ledParams_WS2813  = { .T0H = 350, .T1H = 800, .T0L = 350, .T1L = 350, .TRS = 300000};
+
+typedef union {
+  struct {
+    uint32_t duration0:15;
+    uint32_t level0:1;
+    uint32_t duration1:15;
+    uint32_t level1:1;
+  };
+  uint32_t val;
+} rmtPulsePair;
+
+typedef struct {
+  int      rmtChannel;
+  uint32_t pos, len;           // Bytes of this frame already pulled from the core, and in total
+  uint16_t half, bufIsDirty;
+} rmtChannelState;
+
+static rmtChannelState ws2812_chans[WS2812_MAX_SEGMENTS];
+static int8_t ws2812_segmentOfChannel[RMT_NUM_CHANNELS] = {-1, -1, -1, -1, -1, -1, -1, -1};
+static uint32_t ws2812_ownedIntrMask = 0;   // TX end and threshold bits of the channels in use
+static int ws2812_numChans = 0;
+static volatile int ws2812_chansActive = 0;
+static xSemaphoreHandle ws2812_sem = NULL;
+static int ws2812_frameStarted = 0;
+static intr_handle_t rmt_intr_handle = NULL;
+static rmtPulsePair ws2812_bitval_to_rmt_map[2];
+
+static void rmtBeginFrame(const uint32_t *segmentBytes, int numSegments);
+static void rmtStartFrame();
+static void rmtWaitComplete();
+
+static const ws2812_backend ws2812_rmtBackend = {
+  .name = "rmt",
+  .handlesBrightness = 0,
+  .beginFrame = rmtBeginFrame,
+  .startFrame = rmtStartFrame,
+  .waitComplete = rmtWaitComplete,
+};
+
+static void initRMTChannel(int rmtChannel)
+{
+  RMT.apb_conf.fifo_mask = 1;  //enable memory access, instead of FIFO mode.
+  RMT.apb_conf.mem_tx_wrap_en = 1; //wrap around when hitting end of buffer
+  RMT.conf_ch[rmtChannel].conf0.div_cnt = DIVIDER;
+  RMT.conf_ch[rmtChannel].conf0.mem_size = 1;
+  RMT.conf_ch[rmtChannel].conf0.carrier_en = 0;
+  RMT.conf_ch[rmtChannel].conf0.carrier_out_lv = 1;
+  RMT.conf_ch[rmtChannel].conf0.mem_pd = 0;
+
+  RMT.conf_ch[rmtChannel].conf1.rx_en = 0;
+  RMT.conf_ch[rmtChannel].conf1.mem_owner = 0;
+  RMT.conf_ch[rmtChannel].conf1.tx_conti_mode = 0;    //loop back mode.
+  RMT.conf_ch[rmtChannel].conf1.ref_always_on = 1;    // use apb clock: 80M
+  RMT.conf_ch[rmtChannel].conf1.idle_out_en = 1;
+  RMT.conf_ch[rmtChannel].conf1.idle_out_lv = 0;
+
+  return;
+}
+
+static void copyToRmtBlock_half(int segment)
+{
+  // This fills half an RMT block
+  // When wraparound is happening, we want to keep the inactive half of the RMT block filled
+  rmtChannelState *chan = &ws2812_chans[segment];
+  uint8_t bytes[MAX_PULSES / 8];
+  uint32_t i, j, offset, len, byteval;
+  int ch = chan->rmtChannel;
+
+  offset = chan->half * MAX_PULSES;
+  chan->half = !chan->half;
+
+  len = ws2812_supplyChunk(segment, bytes, MAX_PULSES / 8);
+
+  if (!len) {
+    if (!chan->bufIsDirty) {
+      return;
+    }
+    // Clear the channel's data block and return
+    for (i = 0; i < MAX_PULSES; i++) {
+      RMTMEM.chan[ch].data32[i + offset].val = 0;
+    }
+    chan->bufIsDirty = 0;
+    return;
+  }
+  chan->bufIsDirty = 1;
+
+  for (i = 0; i < len; i++) {
+    byteval = bytes[i];
+
+    #if DEBUG_WS2812_DRIVER
+      snprintf(ws2812_debugBuffer, ws2812_debugBufferSz, "%s%d(", ws2812_debugBuffer, byteval);
+    #endif
+
+    // Shift bits out, MSB first, setting RMTMEM.chan[n].data32[x] to the rmtPulsePair value corresponding to the buffered bit value
+    for (j = 0; j < 8; j++, byteval <<= 1) {
+      int bitval = (byteval >> 7) & 0x01;
+      int data32_idx = i * 8 + offset + j;
+      RMTMEM.chan[ch].data32[data32_idx].val = ws2812_bitval_to_rmt_map[bitval].val;
+      #if DEBUG_WS2812_DRIVER
+        snprintf(ws2812_debugBuffer, ws2812_debugBufferSz, "%s%d", ws2812_debugBuffer, bitval);
+      #endif
+    }
+    #if DEBUG_WS2812_DRIVER
+      snprintf(ws2812_debugBuffer, ws2812_debugBufferSz, "%s) ", ws2812_debugBuffer);
+    #endif
+
+    // Handle the reset bit by stretching duration1 for the final bit in the stream
+    if (i + chan->pos == chan->len - 1) {
+      RMTMEM.chan[ch].data32[i * 8 + offset + 7].duration1 =
+        ledParams.TRS / (RMT_DURATION_NS * DIVIDER);
+      #if DEBUG_WS2812_DRIVER
+        snprintf(ws2812_debugBuffer, ws2812_debugBufferSz, "%sRESET ", ws2812_debugBuffer);
+      #endif
+    }
+  }
+
+  // Clear the remainder of the channel's data not set above
+  for (i *= 8; i < MAX_PULSES; i++) {
+    RMTMEM.chan[ch].data32[i + offset].val = 0;
+  }
+  
+  chan->pos += len;
+
+#if DEBUG_WS2812_DRIVER
+  snprintf(ws2812_debugBuffer, ws2812_debugBufferSz, "%s ", ws2812_debugBuffer);
+#endif
+
+  return;
+}
+
+
+static uint32_t pulsesBeforeUnderrun(int segment)
+{
+  // The reader is in the half that is not due for refilling, and stalls when it reaches the end of it
+  rmtChannelState *chan = &ws2812_chans[segment];
+  uint32_t rpos = RMT_STATUS_MEM_RADDR(RMT.status_ch[chan->rmtChannel]) % (2 * MAX_PULSES);
+  uint32_t end = chan->half ? MAX_PULSES : 2 * MAX_PULSES;
+
+  return (rpos < end) ? end - rpos : 0;
+}
+
+void ws2812_handleInterrupt(void *arg)
+{
+  portBASE_TYPE taskAwoken = 0;
+  uint32_t intr_st = RMT.int_st.val;
+  uint32_t pending, slack[RMT_NUM_CHANNELS];
+  int refill[RMT_NUM_CHANNELS];
+  int numRefill = 0, i, j;
+
+  // Every channel past its threshold, in order of how soon it runs dry
+  pending = (intr_st & RMT_INT_TX_THR_EVENT_MASK) >> 24;
+  while (pending) {
+    int segment = ws2812_segmentOfChannel[__builtin_ctz(pending)];
+    uint32_t s;
+
+    pending &= pending - 1;
+    if (segment < 0) {
+      continue;
+    }
+    s = pulsesBeforeUnderrun(segment);
+    for (j = numRefill; j > 0 && slack[j - 1] > s; j--) {
+      refill[j] = refill[j - 1];
+      slack[j] = slack[j - 1];
+    }
+    refill[j] = segment;
+    slack[j] = s;
+    numRefill++;
+  }
+  for (i = 0; i < numRefill; i++) {
+    copyToRmtBlock_half(refill[i]);
+  }
+
+  pending = intr_st & RMT_INT_TX_END_MASK;
+  while (pending) {
+    int segment = ws2812_segmentOfChannel[__builtin_ctz(pending) / 3];
+
+    pending &= pending - 1;
+    // The frame completes when the last active segment finishes
+    if (segment >= 0 && ws2812_sem && --ws2812_chansActive == 0) {
+      xSemaphoreGiveFromISR(ws2812_sem, &taskAwoken);
+    }
+  }
+
+  // One write for everything serviced; other channels' events and ones that arrived meanwhile stay pending
+  RMT.int_clr.val = intr_st & ws2812_ownedIntrMask;
+
+  return;
+}
+
+static void rmtBeginFrame(const uint32_t *segmentBytes, int numSegments)
+{
+  int i;
+
+  ws2812_chansActive = 0;
+  for (i = 0; i < ws2812_numChans; i++) {
+    rmtChannelState *chan = &ws2812_chans[i];
+
+    chan->len = segmentBytes[i];
+    chan->pos = 0;
+    chan->half = 0;
+
+    if (!chan->len) {
+      continue;
+    }
+
+    copyToRmtBlock_half(i);
+
+    if (chan->pos < chan->len) {
+      // Fill the other half of the buffer block
+      #if DEBUG_WS2812_DRIVER
+        snprintf(ws2812_debugBuffer, ws2812_debugBufferSz, "%s# ", ws2812_debugBuffer);
+      #endif
+      copyToRmtBlock_half(i);
+    }
+    ws2812_chansActive++;
+  }
+
+  // Created once, here rather than in rmtStartFrame(), to keep the allocator off the timed start
+  if (!ws2812_sem) {
+    ws2812_sem = xSemaphoreCreateBinary();
+  }
+  else {
+    // Drop a completion left over from a frame nobody waited for
+    xSemaphoreTake(ws2812_sem, 0);
+  }
+  ws2812_frameStarted = 0;
+
+  return;
+}
+
+static void rmtStartFrame()
+{
+  int i;
+
+  if (!ws2812_chansActive || !ws2812_sem) {
+    return;
+  }
+  ws2812_frameStarted = 1;
+
+  // Start all segments back-to-back so they run in parallel
+  for (i = 0; i < ws2812_numChans; i++) {
+    if (ws2812_chans[i].len) {
+      RMT.conf_ch[ws2812_chans[i].rmtChannel].conf1.mem_rd_rst = 1;
+      RMT.conf_ch[ws2812_chans[i].rmtChannel].conf1.tx_start = 1;
+    }
+  }
+
+  return;
+}
+
+static void rmtWaitComplete()
+{
+  if (!ws2812_frameStarted) {
+    return;
+  }
+
+  xSemaphoreTake(ws2812_sem, portMAX_DELAY);
+  ws2812_frameStarted = 0;
+
+  return;
+}
+
+int ws2812_init(int gpioNum, int ledType)
+{
+  // A single segment on channel 0 that takes however many pixels are passed to ws2812_setColors()
+  ws2812_segment segment = { .gpioNum = gpioNum, .rmtChannel = 0, .length = UINT32_MAX, .reversed = 0 };
+
+  return ws2812_initStrip(&segment, 1, ledType);
+}
+
+int ws2812_initStrip(const ws2812_segment *segments, int numSegments, int ledType)
+{
+  uint32_t channelsUsed = 0;
+  int i;
+
+  switch (ledType) {
+    case LED_WS2812:
+      ledParams = ledParams_WS2812;
+      break;
+    case LED_WS2812B:
+      ledParams = ledParams_WS2812B;
+      break;
+    case LED_SK6812:
+      ledParams = ledParams_SK6812;
+      break;
+    case LED_WS2813:
+      ledParams = ledParams_WS2813;
+      break;
+    default:
+      return -1;
+  }
+
+  if (numSegments < 1 || numSegments > WS2812_MAX_SEGMENTS) {
+    return -1;
+  }
+  for (i = 0; i < numSegments; i++) {
+    int ch = segments[i].rmtChannel;
+    if (ch < 0 || ch >= RMT_NUM_CHANNELS || (channelsUsed & (1U << ch))) {
+      return -1;
+    }
+    channelsUsed |= (1U << ch);
+  }
+
+  DPORT_SET_PERI_REG_MASK(DPORT_PERIP_CLK_EN_REG, DPORT_RMT_CLK_EN);
+  DPORT_CLEAR_PERI_REG_MASK(DPORT_PERIP_RST_EN_REG, DPORT_RMT_RST);
+
+  for (i = 0; i < RMT_NUM_CHANNELS; i++) {
+    ws2812_segmentOfChannel[i] = -1;
+  }
+  ws2812_ownedIntrMask = 0;
+  for (i = 0; i < numSegments; i++) {
+    rmtChannelState *chan = &ws2812_chans[i];
+    chan->rmtChannel = segments[i].rmtChannel;
+    ws2812_segmentOfChannel[chan->rmtChannel] = i;
+    chan->pos = chan->len = 0;
+    chan->half = chan->bufIsDirty = 0;
+
+    rmt_set_pin(static_cast<rmt_channel_t>(chan->rmtChannel),
+                RMT_MODE_TX,
+                static_cast<gpio_num_t>(segments[i].gpioNum));
+
+    initRMTChannel(chan->rmtChannel);
+
+    RMT.tx_lim_ch[chan->rmtChannel].limit = MAX_PULSES;
+    ws2812_ownedIntrMask |= RMT_INT_TX_THR_EVENT_BIT(chan->rmtChannel) | RMT_INT_TX_END_BIT(chan->rmtChannel);
+    RMT.int_ena.val |= RMT_INT_TX_THR_EVENT_BIT(chan->rmtChannel) | RMT_INT_TX_END_BIT(chan->rmtChannel);
+  }
+  ws2812_numChans = numSegments;
+
+  // RMT config for WS2812 bit val 0
+  ws2812_bitval_to_rmt_map[0].level0 = 1;
+  ws2812_bitval_to_rmt_map[0].level1 = 0;
+  ws2812_bitval_to_rmt_map[0].duration0 = ledParams.T0H / (RMT_DURATION_NS * DIVIDER);
+  ws2812_bitval_to_rmt_map[0].duration1 = ledParams.T0L / (RMT_DURATION_NS * DIVIDER);
+  
+  // RMT config for WS2812 bit val 1
+  ws2812_bitval_to_rmt_map[1].level0 = 1;
+  ws2812_bitval_to_rmt_map[1].level1 = 0;
+  ws2812_bitval_to_rmt_map[1].duration0 = ledParams.T1H / (RMT_DURATION_NS * DIVIDER);
+  ws2812_bitval_to_rmt_map[1].duration1 = ledParams.T1L / (RMT_DURATION_NS * DIVIDER);
+
+  if (!rmt_intr_handle) {
+    esp_intr_alloc(ETS_RMT_INTR_SOURCE, 0, ws2812_handleInterrupt, NULL, &rmt_intr_handle);
+  }
+
+  ws2812_setLedType(ledType);
+
+  return ws2812_useBackend(&ws2812_rmtBackend, segments, numSegments);
+}
+
+#endif /* ARDUINO || ESP_PLATFORM */
@@ -0,0 +1,147 @@
+/* 
+ * SPI backend: drives APA102/SK9822 clocked RGB LEDs with SPI DMA on the ESP32.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#if defined(ARDUINO) || defined(ESP_PLATFORM)
+
+#include "ws2812.h"
+#include "ws2812_backend.h"
+#include "apa102.h"
+
+#if defined(ARDUINO)
+  #include "driver/spi_master.h"
+  #include "esp_heap_caps.h"
+#elif defined(ESP_PLATFORM)
+  #include <driver/spi_master.h>
+  #include <esp_heap_caps.h>
+#endif
+
+#define CLOCKED_SPI_HOST    HSPI_HOST
+#define CLOCKED_DMA_CHANNEL 1
+
+static uint8_t *ws2812_spiBuffer = NULL;
+static spi_device_handle_t ws2812_spi = NULL;
+static spi_transaction_t ws2812_spiTrans;
+static int ws2812_spiQueued = 0;
+
+static void spiBeginFrame(const uint32_t *segmentBytes, int numSegments);
+static void spiStartFrame();
+static void spiWaitComplete();
+
+static const ws2812_backend ws2812_spiBackend = {
+  .name = "spi",
+  .handlesBrightness = 1,
+  .beginFrame = spiBeginFrame,
+  .startFrame = spiStartFrame,
+  .waitComplete = spiWaitComplete,
+};
+
+static void spiBeginFrame(const uint32_t *segmentBytes, int numSegments)
+{
+  // Frames are built into the DMA buffer from GRB triplets pulled from the core
+  uint8_t bytes[WS2812_SOURCE_CHUNK * 3];
+  uint8_t brightness = ws2812_getBrightness();
+  uint8_t *p = apa102_startFrame(ws2812_spiBuffer);
+  uint32_t len, i;
+
+  while ((len = ws2812_supplyChunk(0, bytes, sizeof(bytes))) > 0) {
+    for (i = 0; i < len; i += 3) {
+      p = apa102_addPixel(p, bytes[i + 1], bytes[i], bytes[i + 2], brightness);
+    }
+  }
+  p = apa102_endFrame(p, segmentBytes[0] / 3);
+
+  ws2812_spiTrans = spi_transaction_t();
+  ws2812_spiTrans.length = (p - ws2812_spiBuffer) * 8;
+  ws2812_spiTrans.tx_buffer = ws2812_spiBuffer;
+
+  return;
+}
+
+static void spiStartFrame()
+{
+  ws2812_spiQueued = (spi_device_queue_trans(ws2812_spi, &ws2812_spiTrans, portMAX_DELAY) == ESP_OK);
+
+  return;
+}
+
+static void spiWaitComplete()
+{
+  spi_transaction_t *done;
+
+  if (ws2812_spiQueued) {
+    spi_device_get_trans_result(ws2812_spi, &done, portMAX_DELAY);
+    ws2812_spiQueued = 0;
+  }
+
+  return;
+}
+
+int ws2812_initClocked(int dataGpio, int clockGpio, uint32_t length, int ledType, uint32_t clockHz)
+{
+  spi_bus_config_t buscfg = {};
+  spi_device_interface_config_t devcfg = {};
+  ws2812_segment segment = { .gpioNum = dataGpio, .rmtChannel = -1, .length = length, .reversed = 0 };
+  uint32_t frameSize = apa102_frameSize(length);
+
+  switch (ledType) {
+    case LED_APA102:
+    case LED_SK9822:
+      break;
+    default:
+      return -1;
+  }
+
+  ws2812_spiBuffer = (uint8_t *) heap_caps_malloc(frameSize, MALLOC_CAP_DMA);
+  if (!ws2812_spiBuffer) {
+    return -1;
+  }
+
+  buscfg.mosi_io_num = dataGpio;
+  buscfg.miso_io_num = -1;
+  buscfg.sclk_io_num = clockGpio;
+  buscfg.quadwp_io_num = -1;
+  buscfg.quadhd_io_num = -1;
+  buscfg.max_transfer_sz = frameSize;
+
+  devcfg.clock_speed_hz = clockHz;
+  devcfg.mode = 0;
+  devcfg.spics_io_num = -1;
+  devcfg.queue_size = 1;
+
+  if (spi_bus_initialize(CLOCKED_SPI_HOST, &buscfg, CLOCKED_DMA_CHANNEL) != ESP_OK ||
+      spi_bus_add_device(CLOCKED_SPI_HOST, &devcfg, &ws2812_spi) != ESP_OK) {
+    heap_caps_free(ws2812_spiBuffer);
+    ws2812_spiBuffer = NULL;
+    return -1;
+  }
+
+  ws2812_setLedType(ledType);
+
+  return ws2812_useBackend(&ws2812_spiBackend, &segment, 1);
+}
+
+#endif /* ARDUINO || ESP_PLATFORM */
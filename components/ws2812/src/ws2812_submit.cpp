@@ -0,0 +1,225 @@
+/* 
+ * Multi-producer frame submission for the digital RGB LED driver.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ * Each producer owns three buffers. The producer fills the back one and
+ * swaps it with the shared middle one (marked dirty); the committer swaps a
+ * dirty middle with its front one. One atomic exchange per side, no locks.
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "ws2812_submit.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ARDUINO)
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/task.h"
+#elif defined(ESP_PLATFORM)
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+#else
+  #include <sched.h>
+#endif
+
+#define SUBMIT_DIRTY 0x4
+#define SUBMIT_MAX_FRAMES 2 /* Frames one call may send before handing off */
+
+typedef struct {
+  rgbVal  *pixels;
+  uint32_t start, count;
+} submission;
+
+typedef struct {
+  int        ready;       // Set once registration has finished
+  int        priority;
+  uint32_t   maxPixels;
+  submission buffers[3];
+  int        back;        // Owned by the producer
+  int        middle;      // Shared; index | SUBMIT_DIRTY when it holds a new submission
+  int        front;       // Owned by the committer
+} producerState;
+
+static producerState submit_producers[WS2812_MAX_PRODUCERS];
+static int submit_numClaimed = 0;
+static uint32_t submit_length = 0;
+static int submit_pending = 0;        // Something was published since the last combine
+static int submit_transmitting = 0;   // A task is combining and sending
+static int submit_lastFrame = 0;      // The sender has started the last frame it will send
+
+int ws2812_submitInit(uint32_t length)
+{
+  int i, j;
+
+  for (i = 0; i < submit_numClaimed && i < WS2812_MAX_PRODUCERS; i++) {
+    for (j = 0; j < 3; j++) {
+      free(submit_producers[i].buffers[j].pixels);
+    }
+  }
+  memset(submit_producers, 0, sizeof(submit_producers));
+  submit_numClaimed = 0;
+  submit_pending = 0;
+  submit_transmitting = 0;
+  submit_length = length;
+
+  return ws2812_setLength(length);
+}
+
+int ws2812_producerRegister(int priority, uint32_t maxPixels)
+{
+  int id = __atomic_fetch_add(&submit_numClaimed, 1, __ATOMIC_RELAXED);
+  producerState *prod;
+  int i;
+
+  if (id >= WS2812_MAX_PRODUCERS) {
+    return -1;
+  }
+
+  prod = &submit_producers[id];
+  for (i = 0; i < 3; i++) {
+    prod->buffers[i].pixels = (rgbVal *) malloc(maxPixels * sizeof(rgbVal));
+    if (!prod->buffers[i].pixels) {
+      while (i--) {
+        free(prod->buffers[i].pixels);
+        prod->buffers[i].pixels = NULL;
+      }
+      return -1;
+    }
+    prod->buffers[i].count = 0;
+  }
+  prod->priority = priority;
+  prod->maxPixels = maxPixels;
+  prod->back = 0;
+  prod->middle = 1;
+  prod->front = 2;
+  __atomic_store_n(&prod->ready, 1, __ATOMIC_RELEASE);
+
+  return id;
+}
+
+static void combineSubmissions()
+{
+  int order[WS2812_MAX_PRODUCERS];
+  int numReady = 0, i, j;
+
+  // Pick up anything newly published, and sort by priority so the highest is applied last
+  for (i = 0; i < WS2812_MAX_PRODUCERS; i++) {
+    producerState *prod = &submit_producers[i];
+    if (!__atomic_load_n(&prod->ready, __ATOMIC_ACQUIRE)) {
+      continue;
+    }
+    if (__atomic_load_n(&prod->middle, __ATOMIC_RELAXED) & SUBMIT_DIRTY) {
+      prod->front = __atomic_exchange_n(&prod->middle, prod->front, __ATOMIC_ACQ_REL) & ~SUBMIT_DIRTY;
+    }
+    for (j = numReady; j > 0 && submit_producers[order[j - 1]].priority > prod->priority; j--) {
+      order[j] = order[j - 1];
+    }
+    order[j] = i;
+    numReady++;
+  }
+
+  for (i = 0; i < numReady; i++) {
+    const submission *sub = &submit_producers[order[i]].buffers[submit_producers[order[i]].front];
+    uint32_t k;
+    for (k = 0; k < sub->count; k++) {
+      ws2812_setPixel(sub->start + k, sub->pixels[k]);
+    }
+  }
+
+  return;
+}
+
+static void submitYield()
+{
+#if defined(ARDUINO) || defined(ESP_PLATFORM)
+  vTaskDelay(1);   // Not taskYIELD(): the sender may be a lower-priority task on this core
+#else
+  sched_yield();
+#endif
+
+  return;
+}
+
+static int sendPending()
+{
+  // The frame that carries our own submission, plus at most one more for anything published
+  // while it went out. The flag is dropped before looking for more work, and submit_lastFrame
+  // tells a task that found the flag taken whether the sender will still come back for its
+  // submission (clear) or has started its last combine (set), in which case it takes over.
+  int frames = 0;
+
+  while (frames < SUBMIT_MAX_FRAMES && __atomic_load_n(&submit_pending, __ATOMIC_SEQ_CST)) {
+    if (__atomic_exchange_n(&submit_transmitting, 1, __ATOMIC_SEQ_CST)) {
+      if (!__atomic_load_n(&submit_lastFrame, __ATOMIC_SEQ_CST)) {
+        break;
+      }
+      submitYield();
+      continue;
+    }
+    __atomic_store_n(&submit_lastFrame, 0, __ATOMIC_SEQ_CST);
+    for (;;) {
+      if (frames == SUBMIT_MAX_FRAMES - 1) {
+        __atomic_store_n(&submit_lastFrame, 1, __ATOMIC_SEQ_CST);
+      }
+      if (frames == SUBMIT_MAX_FRAMES || !__atomic_exchange_n(&submit_pending, 0, __ATOMIC_SEQ_CST)) {
+        break;
+      }
+      combineSubmissions();
+      ws2812_show();
+      frames++;
+    }
+    __atomic_store_n(&submit_transmitting, 0, __ATOMIC_SEQ_CST);
+  }
+
+  return frames > 0;
+}
+
+int ws2812_producerSubmit(int producer, uint32_t start, uint32_t count, const rgbVal *pixels)
+{
+  producerState *prod;
+  submission *sub;
+
+  if (producer < 0 || producer >= WS2812_MAX_PRODUCERS) {
+    return -1;
+  }
+  prod = &submit_producers[producer];
+  if (!prod->ready || count > prod->maxPixels || start > submit_length || count > submit_length - start) {
+    return -1;
+  }
+
+  sub = &prod->buffers[prod->back];
+  memcpy(sub->pixels, pixels, count * sizeof(rgbVal));
+  sub->start = start;
+  sub->count = count;
+  prod->back = __atomic_exchange_n(&prod->middle, prod->back | SUBMIT_DIRTY, __ATOMIC_ACQ_REL) & ~SUBMIT_DIRTY;
+  __atomic_store_n(&submit_pending, 1, __ATOMIC_SEQ_CST);
+
+  return sendPending();
+}
+
+int ws2812_submitFlush()
+{
+  return sendPending();
+}
@@ -0,0 +1,71 @@
+/* 
+ * Multi-producer frame submission for the digital RGB LED driver.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ * Several tasks (say an effect task and a status task) can each submit whole
+ * frames or partial updates without sharing a lock. Each producer publishes
+ * into its own triple buffer, and whichever submitter finds the driver idle
+ * combines the latest submission of every producer into one frame and sends
+ * it. A submit that arrives while a frame is going out normally returns at
+ * once, and the sending task includes it in at most one extra frame, so no
+ * task sends on others' behalf for more than one frame. A submit that
+ * arrives once the sender has started that last frame instead waits for it
+ * to finish and then sends its own; every submission goes out without
+ * anyone having to call ws2812_submitFlush().
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+
+#ifndef WS2812_SUBMIT_H
+#define WS2812_SUBMIT_H
+
+#include <stdint.h>
+#include "ws2812.h"
+
+#define WS2812_MAX_PRODUCERS 8
+
+/*
+ * Call before any producer starts. Frames are length pixels; pixels that no
+ * producer covers keep whatever was last written to them.
+ */
+extern int ws2812_submitInit(uint32_t length);
+
+/*
+ * Returns a producer id, or -1. Submissions from higher priorities are laid
+ * over lower ones. Safe to call from any task.
+ */
+extern int ws2812_producerRegister(int priority, uint32_t maxPixels);
+
+/*
+ * Replaces the producer's contribution with count pixels at start (count 0
+ * withdraws it). Only one task may submit for a given producer. Returns 1 if
+ * this call sent a frame, 0 if another task was sending (see above), or -1 on
+ * bad arguments. Do not mix with direct ws2812_setColors()/ws2812_show().
+ */
+extern int ws2812_producerSubmit(int producer, uint32_t start, uint32_t count, const rgbVal *pixels);
+
+/* Sends whatever has been submitted but not sent yet; returns 1 if it sent a frame */
+extern int ws2812_submitFlush();
+
+#endif /* WS2812_SUBMIT_H */
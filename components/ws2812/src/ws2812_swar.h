@@ -1,10 +1,12 @@
-/*
- * A driver for the WS2812 RGB LEDs using the RMT peripheral on the ESP32.
+/* 
+ * Packed-pixel arithmetic shared by the compositor and the interpolator.
  *
- * Modifications Copyright (c) 2017 Martin F. Falatic
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
  *
- * Based on public domain code created 19 Nov 2016 by Chris Osborn <fozztexx@fozztexx.com>
- * http://insentricity.com
+ * Red and blue share one 32-bit word as two 16-bit lanes (0x00RR00BB) and
+ * green gets the other, so a lerp costs two multiplies per pixel rather than
+ * three. Only the byte positions matter, so the same code works on
+ * 0xAARRGGBB values and on rgbVal.num alike.
  *
  */
 /* 
@@ -27,36 +29,27 @@
  * THE SOFTWARE.
  */
 
-#ifndef WS2812_DRIVER_H
-#define WS2812_DRIVER_H
 
-#include <stdint.h>
+#ifndef WS2812_SWAR_H
+#define WS2812_SWAR_H
 
-typedef union {
-  struct __attribute__ ((packed)) {
-    uint8_t r, g, b;
-  };
-  uint32_t num;
-} rgbVal;
+#include <stdint.h>
 
-#define DEBUG_WS2812_DRIVER 0
+#define RB_MASK 0x00FF00FF
+#define G_MASK  0x0000FF00
 
-#if DEBUG_WS2812_DRIVER
-char *    ws2812_debugBuffer;
-const int ws2812_debugBufferSz = 1024;
-#endif
+static inline uint32_t lerpRGB(uint32_t dst, uint32_t src, uint32_t a)
+{
+  // a is 0-256; each lane holds at most 0xFF * 256, so nothing spills into its neighbour
+  uint32_t rb = (((src & RB_MASK) * a + (dst & RB_MASK) * (256 - a)) >> 8) & RB_MASK;
+  uint32_t g  = (((src & G_MASK)  * a + (dst & G_MASK)  * (256 - a)) >> 8) & G_MASK;
 
-enum led_types {LED_WS2812, LED_WS2812B, LED_SK6812, LED_WS2813};
-extern int  ws2812_init(int gpioNum, int ledType);
-extern void ws2812_setColors(uint16_t length, rgbVal *array);
+  return rb | g;
+}
 
-inline rgbVal makeRGBVal(uint8_t r, uint8_t g, uint8_t b)
+static inline uint32_t scaleRGB(uint32_t src, uint32_t a)
 {
-  rgbVal v;
-  v.r = r;
-  v.g = g;
-  v.b = b;
-  return v;
+  return ((((src & RB_MASK) * a) >> 8) & RB_MASK) | ((((src & G_MASK) * a) >> 8) & G_MASK);
 }
 
-#endif /* WS2812_DRIVER_H */
+#endif /* WS2812_SWAR_H */
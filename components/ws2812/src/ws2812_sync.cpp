@@ -0,0 +1,504 @@
+/* 
+ * Synchronised presentation across several controllers over UDP.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "ws2812_sync.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ARDUINO)
+  #include "esp_timer.h"
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/task.h"
+  #include "lwip/sockets.h"
+#elif defined(ESP_PLATFORM)
+  #include <esp_timer.h>
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+  #include <lwip/sockets.h>
+#else
+  #include <arpa/inet.h>
+  #include <netinet/in.h>
+  #include <sys/select.h>
+  #include <sys/socket.h>
+  #include <time.h>
+  #include <unistd.h>
+#endif
+
+#define SYNC_TIME_REQUEST   1
+#define SYNC_TIME_RESPONSE  2
+#define SYNC_FRAME          3
+#define SYNC_SKEW_REPORT    4
+
+#define SYNC_INTERVAL_US    1000000 /* How often a controller re-measures its clock offset */
+#define SYNC_SPIN_US           2000 /* Sleep until this close to a start time, then spin */
+#define SYNC_MAX_REJECTS          3 /* Slow exchanges ignored in a row before one is accepted anyway */
+
+// All packets are little-endian, as on both the ESP32 and x86 hosts
+typedef struct __attribute__ ((packed)) {
+  uint8_t  type;
+  uint8_t  reserved[3];
+  uint32_t seq;
+  int64_t  t0, t1, t2;   // Client send, server receive, server send
+} timePacket;
+
+typedef struct __attribute__ ((packed)) {
+  uint8_t  type;
+  uint8_t  reserved[3];
+  uint32_t frameId;
+  int64_t  presentUs;    // On the server clock
+  uint32_t numPixels;    // In the whole frame
+  uint32_t offset;       // First pixel in this fragment
+  uint32_t count;        // Pixels in this fragment
+  uint8_t  rgb[WS2812_SYNC_PIXELS_PER_PACKET * 3];
+} framePacket;
+
+typedef struct __attribute__ ((packed)) {
+  uint8_t  type;
+  uint8_t  late;
+  uint8_t  reserved[2];
+  uint32_t frameId;
+  int64_t  skewUs;
+} skewPacket;
+
+#define FRAME_HEADER_SIZE (sizeof(framePacket) - WS2812_SYNC_PIXELS_PER_PACKET * 3)
+
+typedef struct {
+  struct sockaddr_in addr;
+  ws2812_syncStats   stats;
+} syncClient;
+
+// Server state
+static int sync_serverSock = -1;
+static syncClient sync_clients[WS2812_SYNC_MAX_CLIENTS];
+static int sync_numClients = 0;
+
+// Controller state
+static int sync_clientSock = -1;
+static struct sockaddr_in sync_serverAddr;
+static ws2812_syncStats sync_stats;
+static int64_t sync_lastRequestUs = 0;
+static uint32_t sync_seq = 0;
+static int sync_haveOffset = 0, sync_rejects = 0;
+static int sync_requestOutstanding = 0;
+static uint32_t sync_maxPixels = 0;
+static uint32_t sync_frameId = 0, sync_frameReceived = 0, sync_frameLength = 0;
+static int64_t sync_framePresentUs = 0;
+static int sync_frameActive = 0, sync_haveFrameId = 0;
+static uint8_t *sync_fragments = NULL;     // One bit per fragment of the frame being assembled
+
+int64_t ws2812_syncNowUs()
+{
+#if defined(ARDUINO) || defined(ESP_PLATFORM)
+  return esp_timer_get_time();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+static void syncSleepUs(int64_t us)
+{
+#if defined(ARDUINO) || defined(ESP_PLATFORM)
+  vTaskDelay((us / 1000) / portTICK_PERIOD_MS);
+#else
+  usleep(us);
+#endif
+}
+
+static int waitReadable(int sock, int64_t timeoutUs)
+{
+  fd_set fds;
+  struct timeval tv;
+
+  if (timeoutUs < 0) {
+    timeoutUs = 0;
+  }
+  FD_ZERO(&fds);
+  FD_SET(sock, &fds);
+  tv.tv_sec = timeoutUs / 1000000;
+  tv.tv_usec = timeoutUs % 1000000;
+
+  return select(sock + 1, &fds, NULL, NULL, &tv) > 0;
+}
+
+static int openSocket(uint16_t port)
+{
+  struct sockaddr_in addr;
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+
+  if (sock < 0) {
+    return -1;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (bind(sock, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+    close(sock);
+    return -1;
+  }
+
+  return sock;
+}
+
+static int findClient(const struct sockaddr_in *addr, int add)
+{
+  int i;
+
+  for (i = 0; i < sync_numClients; i++) {
+    if (sync_clients[i].addr.sin_addr.s_addr == addr->sin_addr.s_addr &&
+        sync_clients[i].addr.sin_port == addr->sin_port) {
+      return i;
+    }
+  }
+  if (!add || sync_numClients == WS2812_SYNC_MAX_CLIENTS) {
+    return -1;
+  }
+
+  memset(&sync_clients[sync_numClients], 0, sizeof(syncClient));
+  sync_clients[sync_numClients].addr = *addr;
+
+  return sync_numClients++;
+}
+
+int ws2812_syncServerInit(uint16_t port)
+{
+  sync_serverSock = openSocket(port);
+  sync_numClients = 0;
+
+  return (sync_serverSock < 0) ? -1 : 0;
+}
+
+void ws2812_syncServerPoll(int timeoutMs)
+{
+  int64_t deadline = ws2812_syncNowUs() + (int64_t) timeoutMs * 1000;
+  union {
+    timePacket time;
+    skewPacket skew;
+    uint8_t    type;
+  } packet;
+
+  while (waitReadable(sync_serverSock, deadline - ws2812_syncNowUs())) {
+    struct sockaddr_in from;
+    socklen_t fromLen = sizeof(from);
+    int len = recvfrom(sync_serverSock, &packet, sizeof(packet), 0, (struct sockaddr *) &from, &fromLen);
+    int64_t received = ws2812_syncNowUs();
+    int client;
+
+    if (len == sizeof(timePacket) && packet.type == SYNC_TIME_REQUEST) {
+      if (findClient(&from, 1) < 0) {
+        continue;
+      }
+      packet.time.type = SYNC_TIME_RESPONSE;
+      packet.time.t1 = received;
+      packet.time.t2 = ws2812_syncNowUs();
+      sendto(sync_serverSock, &packet.time, sizeof(timePacket), 0, (struct sockaddr *) &from, fromLen);
+    }
+    else if (len == sizeof(skewPacket) && packet.type == SYNC_SKEW_REPORT) {
+      if ((client = findClient(&from, 0)) < 0) {
+        continue;
+      }
+      sync_clients[client].stats.lastSkewUs = packet.skew.skewUs;
+      sync_clients[client].stats.framesShown++;
+      sync_clients[client].stats.framesLate += packet.skew.late;
+    }
+  }
+
+  return;
+}
+
+int ws2812_syncServerNumClients()
+{
+  return sync_numClients;
+}
+
+const ws2812_syncStats *ws2812_syncServerClientStats(int client)
+{
+  return (client >= 0 && client < sync_numClients) ? &sync_clients[client].stats : NULL;
+}
+
+int ws2812_syncServerSendFrame(int client, uint32_t frameId, int64_t presentUs,
+                               const rgbVal *pixels, uint32_t numPixels)
+{
+  framePacket packet;
+  uint32_t offset, i;
+
+  if (client < 0 || client >= sync_numClients) {
+    return -1;
+  }
+
+  packet.type = SYNC_FRAME;
+  packet.frameId = frameId;
+  packet.presentUs = presentUs;
+  packet.numPixels = numPixels;
+  for (offset = 0; offset < numPixels; offset += packet.count) {
+    packet.offset = offset;
+    packet.count = (numPixels - offset > WS2812_SYNC_PIXELS_PER_PACKET) ? WS2812_SYNC_PIXELS_PER_PACKET : numPixels - offset;
+    for (i = 0; i < packet.count; i++) {
+      packet.rgb[i * 3 + 0] = pixels[offset + i].r;
+      packet.rgb[i * 3 + 1] = pixels[offset + i].g;
+      packet.rgb[i * 3 + 2] = pixels[offset + i].b;
+    }
+    if (sendto(sync_serverSock, &packet, FRAME_HEADER_SIZE + packet.count * 3, 0,
+               (struct sockaddr *) &sync_clients[client].addr, sizeof(struct sockaddr_in)) < 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+int ws2812_syncClientInit(const char *serverIp, uint16_t serverPort, uint32_t maxPixels)
+{
+  sync_clientSock = openSocket(0);
+  if (sync_clientSock < 0) {
+    return -1;
+  }
+
+  memset(&sync_serverAddr, 0, sizeof(sync_serverAddr));
+  sync_serverAddr.sin_family = AF_INET;
+  sync_serverAddr.sin_addr.s_addr = inet_addr(serverIp);
+  sync_serverAddr.sin_port = htons(serverPort);
+
+  memset(&sync_stats, 0, sizeof(sync_stats));
+  sync_haveOffset = sync_rejects = 0;
+  sync_requestOutstanding = 0;
+  sync_frameActive = 0;
+  sync_haveFrameId = 0;
+  sync_maxPixels = maxPixels;
+
+  free(sync_fragments);
+  sync_fragments = (uint8_t *) calloc((maxPixels / WS2812_SYNC_PIXELS_PER_PACKET + 8) / 8, 1);
+  if (!sync_fragments) {
+    close(sync_clientSock);
+    sync_clientSock = -1;
+    return -1;
+  }
+  sync_lastRequestUs = ws2812_syncNowUs() - SYNC_INTERVAL_US;
+
+  return 0;
+}
+
+const ws2812_syncStats *ws2812_syncClientStats()
+{
+  return &sync_stats;
+}
+
+static void updateOffset(const timePacket *packet, int64_t t3)
+{
+  int64_t rtt = (t3 - packet->t0) - (packet->t2 - packet->t1);
+  int64_t offset = ((packet->t1 - packet->t0) + (packet->t2 - t3)) / 2;
+
+  // An exchange that took much longer than the last good one was probably queued
+  // somewhere, which skews its offset; skip a few of those before trusting one again
+  if (sync_haveOffset && rtt > 2 * sync_stats.rttUs + 1000 && ++sync_rejects <= SYNC_MAX_REJECTS) {
+    return;
+  }
+
+  sync_stats.offsetUs = offset;
+  sync_stats.rttUs = rtt;
+  sync_haveOffset = 1;
+  sync_rejects = 0;
+
+  return;
+}
+
+static void handleTimeResponse(const timePacket *packet, int64_t t3)
+{
+  if (packet->type == SYNC_TIME_RESPONSE && sync_requestOutstanding && packet->seq == sync_seq) {
+    sync_requestOutstanding = 0;
+    updateOffset(packet, t3);
+  }
+
+  return;
+}
+
+static int waitUntil(int64_t targetUs)
+{
+  // Sleep for most of the wait, then spin so the start lands on the microsecond. While
+  // sleeping, time responses are taken off the socket as they arrive so they are stamped
+  // on time; anything else is left for ws2812_syncClientPoll().
+  int64_t sleepUntil = targetUs - SYNC_SPIN_US;
+  int64_t now = ws2812_syncNowUs();
+  timePacket packet;
+  uint8_t type;
+
+  if (targetUs <= now) {
+    return 0;
+  }
+  while (now < sleepUntil) {
+    if (!waitReadable(sync_clientSock, sleepUntil - now)) {
+      break;
+    }
+    if (recv(sync_clientSock, &type, 1, MSG_PEEK) != 1 || type != SYNC_TIME_RESPONSE) {
+      now = ws2812_syncNowUs();
+      if (now < sleepUntil) {
+        syncSleepUs(sleepUntil - now);
+      }
+      break;
+    }
+    if (recv(sync_clientSock, &packet, sizeof(packet), 0) == sizeof(timePacket)) {
+      handleTimeResponse(&packet, ws2812_syncNowUs());
+    }
+    now = ws2812_syncNowUs();
+  }
+  while (ws2812_syncNowUs() < targetUs) {
+  }
+
+  return 1;
+}
+
+static void presentFrame()
+{
+  skewPacket report;
+  int64_t startedUs;
+  int onTime;
+
+  ws2812_prepare();
+  onTime = waitUntil(sync_framePresentUs - sync_stats.offsetUs);
+  ws2812_start();
+  startedUs = ws2812_syncNowUs();
+  ws2812_waitComplete();
+
+  // A reply that came in during the transmission would be stamped late, so ask again instead
+  if (sync_requestOutstanding) {
+    sync_requestOutstanding = 0;
+    sync_seq++;
+    sync_lastRequestUs = ws2812_syncNowUs() - SYNC_INTERVAL_US;
+  }
+
+  memset(&report, 0, sizeof(report));
+  report.type = SYNC_SKEW_REPORT;
+  report.late = !onTime;
+  report.frameId = sync_frameId;
+  report.skewUs = startedUs + sync_stats.offsetUs - sync_framePresentUs;
+  sendto(sync_clientSock, &report, sizeof(report), 0, (struct sockaddr *) &sync_serverAddr, sizeof(sync_serverAddr));
+
+  sync_stats.lastSkewUs = report.skewUs;
+  sync_stats.framesShown++;
+  sync_stats.framesLate += report.late;
+
+  return;
+}
+
+int ws2812_syncClientPoll(int timeoutMs)
+{
+  int64_t deadline = ws2812_syncNowUs() + (int64_t) timeoutMs * 1000;
+  union {
+    timePacket  time;
+    framePacket frame;
+    uint8_t     type;
+  } packet;
+
+  for (;;) {
+    int64_t now = ws2812_syncNowUs();
+    int64_t wait;
+    uint32_t i;
+    int len;
+
+    if (now - sync_lastRequestUs >= SYNC_INTERVAL_US) {
+      timePacket request;
+      memset(&request, 0, sizeof(request));
+      request.type = SYNC_TIME_REQUEST;
+      request.seq = ++sync_seq;
+      request.t0 = now;
+      sendto(sync_clientSock, &request, sizeof(request), 0, (struct sockaddr *) &sync_serverAddr, sizeof(sync_serverAddr));
+      sync_lastRequestUs = now;
+      sync_requestOutstanding = 1;
+    }
+
+    wait = deadline - now;
+    if (wait <= 0) {
+      return 0;
+    }
+    if (wait > sync_lastRequestUs + SYNC_INTERVAL_US - now) {
+      wait = sync_lastRequestUs + SYNC_INTERVAL_US - now;
+    }
+    if (!waitReadable(sync_clientSock, wait)) {
+      continue;
+    }
+
+    len = recv(sync_clientSock, &packet, sizeof(packet), 0);
+    if (len == sizeof(timePacket)) {
+      handleTimeResponse(&packet.time, ws2812_syncNowUs());
+    }
+    else if (len >= (int) FRAME_HEADER_SIZE && packet.type == SYNC_FRAME &&
+             len == (int) (FRAME_HEADER_SIZE + packet.frame.count * 3)) {
+      // Frame ids wrap, so compare them as serial numbers. A fragment of a newer frame abandons
+      // whatever is left of the current one; late fragments of older or finished frames are dropped.
+      int32_t age = (int32_t) (packet.frame.frameId - sync_frameId);
+      uint32_t fragment;
+
+      if (!sync_haveFrameId || age > 0) {
+        if (!packet.frame.numPixels || packet.frame.numPixels > sync_maxPixels ||
+            ws2812_setLength(packet.frame.numPixels)) {
+          continue;
+        }
+        sync_frameId = packet.frame.frameId;
+        sync_haveFrameId = 1;
+        sync_framePresentUs = packet.frame.presentUs;
+        sync_frameLength = packet.frame.numPixels;
+        sync_frameReceived = 0;
+        sync_frameActive = 1;
+        memset(sync_fragments, 0, (sync_frameLength / WS2812_SYNC_PIXELS_PER_PACKET + 8) / 8);
+      }
+      else if (age < 0 || !sync_frameActive) {
+        continue;
+      }
+
+      // Fragments are whole packets from the start of the frame; count each one only once
+      if (packet.frame.offset % WS2812_SYNC_PIXELS_PER_PACKET || packet.frame.offset >= sync_frameLength ||
+          packet.frame.count != ((sync_frameLength - packet.frame.offset > WS2812_SYNC_PIXELS_PER_PACKET) ?
+                                 WS2812_SYNC_PIXELS_PER_PACKET : sync_frameLength - packet.frame.offset)) {
+        continue;
+      }
+      fragment = packet.frame.offset / WS2812_SYNC_PIXELS_PER_PACKET;
+      if (sync_fragments[fragment / 8] & (1 << (fragment % 8))) {
+        continue;
+      }
+      sync_fragments[fragment / 8] |= 1 << (fragment % 8);
+
+      for (i = 0; i < packet.frame.count; i++) {
+        ws2812_setPixel(packet.frame.offset + i, makeRGBVal(packet.frame.rgb[i * 3 + 0],
+                                                            packet.frame.rgb[i * 3 + 1],
+                                                            packet.frame.rgb[i * 3 + 2]));
+      }
+      sync_frameReceived += packet.frame.count;
+      if (sync_frameReceived >= sync_frameLength) {
+        sync_frameActive = 0;
+        if (!sync_haveOffset) {
+          continue; // No way to place it in time yet, so drop it
+        }
+        presentFrame();
+        return 1;
+      }
+    }
+  }
+}
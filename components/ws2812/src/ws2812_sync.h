@@ -0,0 +1,79 @@
+/* 
+ * Synchronised presentation across several controllers over UDP.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ * One server (an ESP32 or a host) keeps the reference clock and sends each
+ * controller its frames tagged with a presentation time on that clock.
+ * Controllers estimate their offset from the server clock with a simple
+ * NTP-style exchange, prepare each frame ahead of time and start it when
+ * the local clock reaches the presentation time, then report the achieved
+ * skew back to the server. Sockets are plain BSD sockets, so several
+ * controllers can be run as processes on one Linux machine.
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef WS2812_SYNC_H
+#define WS2812_SYNC_H
+
+#include <stdint.h>
+#include "ws2812.h"
+
+#define WS2812_SYNC_MAX_CLIENTS      16
+#define WS2812_SYNC_PIXELS_PER_PACKET 400 /* Keeps each frame fragment inside one Ethernet MTU */
+
+typedef struct {
+  int64_t  offsetUs;      /* Server clock minus local clock */
+  int64_t  rttUs;         /* Round trip of the exchange the offset came from */
+  int64_t  lastSkewUs;    /* Achieved start minus presentation time, on the server clock */
+  uint32_t framesShown;
+  uint32_t framesLate;    /* Frames whose presentation time had passed by the time they were ready */
+} ws2812_syncStats;
+
+/* Monotonic microsecond clock used for presentation times */
+extern int64_t ws2812_syncNowUs();
+
+/*
+ * Server side. Controllers register themselves by sending their first time
+ * request; ws2812_syncServerPoll() answers time requests and collects skew
+ * reports for up to timeoutMs. Clients are numbered in order of registration.
+ */
+extern int  ws2812_syncServerInit(uint16_t port);
+extern void ws2812_syncServerPoll(int timeoutMs);
+extern int  ws2812_syncServerNumClients();
+extern int  ws2812_syncServerSendFrame(int client, uint32_t frameId, int64_t presentUs,
+                                       const rgbVal *pixels, uint32_t numPixels);
+extern const ws2812_syncStats *ws2812_syncServerClientStats(int client);
+
+/*
+ * Controller side. ws2812_syncClientPoll() keeps the clock offset fresh and
+ * assembles incoming frames into the driver's framebuffer; once a frame is
+ * complete it prepares it, waits for its presentation time, starts it and
+ * returns 1 after it has been sent. It returns 0 if no frame was shown
+ * within timeoutMs. Frames longer than maxPixels (the strip) are dropped.
+ */
+extern int  ws2812_syncClientInit(const char *serverIp, uint16_t serverPort, uint32_t maxPixels);
+extern int  ws2812_syncClientPoll(int timeoutMs);
+extern const ws2812_syncStats *ws2812_syncClientStats();
+
+#endif /* WS2812_SYNC_H */
@@ -0,0 +1,116 @@
+/* 
+ * Host check for the APA102/SK9822 frame builder: compares the frames built
+ * by apa102.cpp against known byte vectors. Exits non-zero on a mismatch.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+
+#include "apa102.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int failures = 0;
+
+void expectBytes(const char *what, const uint8_t *got, const uint8_t *want, uint32_t len)
+{
+  if (memcmp(got, want, len)) {
+    printf("FAIL %s:", what);
+    for (uint32_t i = 0; i < len; i++) {
+      printf(" %02x", got[i]);
+    }
+    printf("\n");
+    failures++;
+  }
+}
+
+void expectValue(const char *what, uint32_t got, uint32_t want)
+{
+  if (got != want) {
+    printf("FAIL %s: %u, expected %u\n", what, got, want);
+    failures++;
+  }
+}
+
+void checkPixel(const char *what, uint8_t r, uint8_t g, uint8_t b, uint8_t brightness,
+                uint8_t w0, uint8_t w1, uint8_t w2, uint8_t w3)
+{
+  uint8_t got[4];
+  const uint8_t want[4] = {w0, w1, w2, w3};
+
+  expectValue(what, apa102_addPixel(got, r, g, b, brightness) - got, 4);
+  expectBytes(what, got, want, 4);
+}
+
+void checkFrame(uint32_t numPixels)
+{
+  // Zero start frame, one 4-byte word per pixel, then at least 4 + N/16 zero bytes of end frame
+  static uint8_t frame[4 + 64 * 4 + 4 + 4 + 1];   // One spare byte to catch overruns
+  static const uint8_t zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  grbVal pixels[64];
+  uint32_t endLen = 4 + (numPixels + 15) / 16;
+  uint32_t len, i;
+  char what[32];
+
+  for (i = 0; i < numPixels; i++) {
+    pixels[i] = makeGRBVal(255, 128, 1);
+  }
+  memset(frame, 0xAA, sizeof(frame));
+  len = apa102_buildFrame(frame, pixels, numPixels, 255);
+
+  snprintf(what, sizeof(what), "frame length, %u pixels", numPixels);
+  expectValue(what, len, 4 + numPixels * 4 + endLen);
+  expectValue(what, apa102_frameSize(numPixels), len);
+  snprintf(what, sizeof(what), "start frame, %u pixels", numPixels);
+  expectBytes(what, frame, zeros, 4);
+  for (i = 0; i < numPixels; i++) {
+    const uint8_t want[4] = {0xFF, 0x01, 0x80, 0xFF};
+    snprintf(what, sizeof(what), "pixel %u of %u", i, numPixels);
+    expectBytes(what, frame + 4 + i * 4, want, 4);
+  }
+  snprintf(what, sizeof(what), "end frame, %u pixels", numPixels);
+  expectBytes(what, frame + 4 + numPixels * 4, zeros, endLen);
+  expectValue(what, frame[len], 0xAA);
+}
+
+int main()
+{
+  // Header byte is 0xE0 | 5-bit global, then blue, green, red
+  checkPixel("full scale", 255, 128, 1, 255, 0xFF, 0x01, 0x80, 0xFF);
+  checkPixel("black", 0, 0, 0, 255, 0xE0, 0x00, 0x00, 0x00);
+  checkPixel("zero brightness", 255, 255, 255, 0, 0xE0, 0x00, 0x00, 0x00);
+  checkPixel("half brightness", 255, 255, 255, 127, 0xF0, 0xF6, 0xF6, 0xF6);
+  checkPixel("dim colour", 8, 4, 2, 255, 0xE1, 0x3E, 0x7C, 0xF8);
+
+  checkFrame(0);
+  checkFrame(1);
+  checkFrame(16);
+  checkFrame(17);
+  checkFrame(64);
+
+  printf(failures ? "%d failures\n" : "ok\n", failures);
+
+  return failures ? 1 : 0;
+}
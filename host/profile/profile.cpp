@@ -0,0 +1,95 @@
+/* 
+ * Host profiling demo: renders and encodes frames through the null backend
+ * (or the file backend, given an output path) so the pipeline can be timed
+ * or run under perf on Linux.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "ws2812.h"
+#include "ws2812_backend.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+const uint32_t NUM_PIXELS = 4096;
+const int NUM_FRAMES = 2000;
+
+double nowSeconds()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void render(grbVal *pixels, int frame)
+{
+  for (uint32_t i = 0; i < NUM_PIXELS; i++) {
+    uint8_t v = (uint8_t) (i + frame);
+    pixels[i] = makeGRBVal(v, 255 - v, (uint8_t) (v * 2));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  // Four segments, the last one reversed, to exercise the same paths as a sharded strip
+  ws2812_segment segments[4] = {
+    { .gpioNum = 0, .rmtChannel = 0, .length = NUM_PIXELS / 4, .reversed = 0 },
+    { .gpioNum = 0, .rmtChannel = 1, .length = NUM_PIXELS / 4, .reversed = 0 },
+    { .gpioNum = 0, .rmtChannel = 2, .length = NUM_PIXELS / 4, .reversed = 0 },
+    { .gpioNum = 0, .rmtChannel = 3, .length = NUM_PIXELS / 4, .reversed = 1 },
+  };
+  FILE *out = NULL;
+
+  if (argc > 1) {
+    out = fopen(argv[1], "wb");
+    if (ws2812_initFile(out, segments, 4)) {
+      fprintf(stderr, "Cannot open %s\n", argv[1]);
+      return 1;
+    }
+  }
+  else {
+    ws2812_useBackend(&ws2812_nullBackend, segments, 4);
+  }
+  ws2812_setBrightness(128);
+
+  grbVal *pixels = ws2812_getPixels(NUM_PIXELS);
+  double start = nowSeconds();
+  for (int frame = 0; frame < NUM_FRAMES; frame++) {
+    render(pixels, frame);
+    ws2812_show();
+  }
+  double elapsed = nowSeconds() - start;
+
+  printf("%d frames of %u pixels in %.3f s: %.1f frames/s, %.1f Mpixels/s\n",
+         NUM_FRAMES, NUM_PIXELS, elapsed, NUM_FRAMES / elapsed,
+         NUM_FRAMES * (double) NUM_PIXELS / elapsed / 1e6);
+
+  if (out) {
+    fclose(out);
+  }
+
+  return 0;
+}
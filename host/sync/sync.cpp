@@ -0,0 +1,132 @@
+/* 
+ * Host demo for synchronised presentation: run one server and any number
+ * of clients as separate processes, e.g.
+ *
+ *   ./sync server 7000 2 300 &
+ *   ./sync client 127.0.0.1 7000 256 &
+ *   ./sync client 127.0.0.1 7000 256
+ *
+ * Clients encode through the null backend; the server prints the skew each
+ * client reports.
+ *
+ * Copyright (c) 2026 ESP32 Digital RGB LED Drivers contributors
+ *
+ */
+/* 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "ws2812.h"
+#include "ws2812_backend.h"
+#include "ws2812_sync.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const int64_t PRESENT_DELAY_US = 100000; // Lead time that covers network and preparation
+const int64_t FRAME_PERIOD_US = 33333;
+
+int runServer(uint16_t port, int numClients, int numFrames)
+{
+  rgbVal *pixels;
+  const uint32_t numPixels = 256;
+
+  if (ws2812_syncServerInit(port)) {
+    fprintf(stderr, "Cannot listen on port %u\n", port);
+    return 1;
+  }
+
+  printf("Waiting for %d clients...\n", numClients);
+  while (ws2812_syncServerNumClients() < numClients) {
+    ws2812_syncServerPoll(100);
+  }
+
+  pixels = (rgbVal *) malloc(sizeof(rgbVal) * numPixels);
+  int64_t next = ws2812_syncNowUs();
+  for (int frame = 0; frame < numFrames; frame++) {
+    for (int c = 0; c < ws2812_syncServerNumClients(); c++) {
+      // A dot that runs across the clients in turn, so tearing between them is easy to spot
+      memset(pixels, 0, sizeof(rgbVal) * numPixels);
+      pixels[(frame + c * 32) % numPixels] = makeRGBVal(255, 255, 255);
+      ws2812_syncServerSendFrame(c, frame, next + PRESENT_DELAY_US, pixels, numPixels);
+    }
+    next += FRAME_PERIOD_US;
+    ws2812_syncServerPoll((next - ws2812_syncNowUs()) / 1000);
+  }
+  ws2812_syncServerPoll(500);
+
+  for (int c = 0; c < ws2812_syncServerNumClients(); c++) {
+    const ws2812_syncStats *stats = ws2812_syncServerClientStats(c);
+    printf("client %d: %u frames shown, %u late, last skew %lld us\n",
+           c, stats->framesShown, stats->framesLate, (long long) stats->lastSkewUs);
+  }
+  free(pixels);
+
+  return 0;
+}
+
+int runClient(const char *serverIp, uint16_t port, uint32_t numPixels)
+{
+  ws2812_segment segment = { .gpioNum = 0, .rmtChannel = 0, .length = numPixels, .reversed = 0 };
+  int64_t worstSkew = 0;
+  int idle = 0;
+
+  ws2812_useBackend(&ws2812_nullBackend, &segment, 1);
+  if (ws2812_syncClientInit(serverIp, port, numPixels)) {
+    fprintf(stderr, "Cannot open socket\n");
+    return 1;
+  }
+
+  // Run until the server has gone quiet for a few seconds
+  while (idle < 3) {
+    if (ws2812_syncClientPoll(1000)) {
+      int64_t skew = ws2812_syncClientStats()->lastSkewUs;
+      if (llabs(skew) > llabs(worstSkew)) {
+        worstSkew = skew;
+      }
+      idle = 0;
+    }
+    else if (ws2812_syncClientStats()->framesShown) {
+      idle++;
+    }
+  }
+
+  const ws2812_syncStats *stats = ws2812_syncClientStats();
+  printf("%u frames shown, %u late, offset %lld us (rtt %lld us), worst skew %lld us\n",
+         stats->framesShown, stats->framesLate, (long long) stats->offsetUs,
+         (long long) stats->rttUs, (long long) worstSkew);
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc == 5 && !strcmp(argv[1], "server")) {
+    return runServer(atoi(argv[2]), atoi(argv[3]), atoi(argv[4]));
+  }
+  if (argc == 5 && !strcmp(argv[1], "client")) {
+    return runClient(argv[2], atoi(argv[3]), atoi(argv[4]));
+  }
+
+  fprintf(stderr, "usage: %s server <port> <clients> <frames>\n"
+                  "       %s client <server ip> <port> <pixels>\n", argv[0], argv[0]);
+  return 1;
+}